@@ -38,6 +38,8 @@
 #include <collection.h>
 #include <windows.devices.alljoyn.interop.h>
 #include <map>
+#include <unordered_map>
+#include <wrl/wrappers/corewrappers.h>
 
 #include <alljoyn_c/busattachment.h>
 #include <alljoyn_c/dbusstddefines.h>
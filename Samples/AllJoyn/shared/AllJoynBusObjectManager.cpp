@@ -31,48 +31,63 @@
 //-----------------------------------------------------------------------------
 #include "pch.h"
 
-std::mutex AllJoynBusObjectManager::ModifyBusObjectMap;
-std::map<alljoyn_busattachment, std::shared_ptr<std::map<std::string, std::tuple<alljoyn_busobject, bool, int>>>> AllJoynBusObjectManager::BusAttachmentMap;
+AllJoynBusObjectManager::BusObjectShard AllJoynBusObjectManager::BusObjectShards[AllJoynBusObjectManager::c_BusObjectShardCount];
 
 QStatus AllJoynBusObjectManager::GetBusObject(_In_ const alljoyn_busattachment busAttachment, _In_ const PCSTR objectPath, _Out_ alljoyn_busobject* busObject)
 {
+    size_t hash = AllJoynBusObjectManager::HashBusObject(busAttachment, objectPath);
+    BusObjectShard& shard = AllJoynBusObjectManager::BusObjectShards[hash % c_BusObjectShardCount];
+
     // Ensure thread safety when creating BusObjects so that for each BusAttachment there is
     // at most one BusObject with any given ObjectPath.
-    std::unique_lock<std::mutex> lock(AllJoynBusObjectManager::ModifyBusObjectMap);
+    auto lock = shard.Lock.LockExclusive();
 
-    if (AllJoynBusObjectManager::BusObjectExists(busAttachment, objectPath))
+    BusObjectEntry* busObjectEntry = AllJoynBusObjectManager::FindBusObject(shard, hash, busAttachment, objectPath);
+    if (nullptr != busObjectEntry)
     {
-        std::tuple<alljoyn_busobject, bool, int>& busObjectEntry = (*AllJoynBusObjectManager::BusAttachmentMap[busAttachment])[objectPath];
-        *busObject = std::get<0>(busObjectEntry);
+        *busObject = busObjectEntry->BusObject;
 
         // Increment the reference counter for this entry.
-        std::get<2>(busObjectEntry)++;
+        busObjectEntry->ReferenceCount++;
         return ER_OK;
     }
+
     // If a matching BusObject does not exist, create and save one.
     RETURN_IF_QSTATUS_ERROR(AllJoynBusObjectManager::CreateBusObject(objectPath, busObject));
-    return AllJoynBusObjectManager::SaveBusObject(busAttachment, objectPath, *busObject);
+
+    // Initialize the BusObject entry as "not registered" and with a single reference.
+    BusObjectEntry newEntry = { busAttachment, objectPath, *busObject, false, 1 };
+    shard.Entries.insert(std::make_pair(hash, std::move(newEntry)));
+    return ER_OK;
 }
 
 QStatus AllJoynBusObjectManager::ReleaseBusObject(_Inout_ alljoyn_busattachment busAttachment, _In_ const PCSTR objectPath)
 {
+    size_t hash = AllJoynBusObjectManager::HashBusObject(busAttachment, objectPath);
+    BusObjectShard& shard = AllJoynBusObjectManager::BusObjectShards[hash % c_BusObjectShardCount];
+
     // Ensure thread safety when releasing BusObjects. Otherwise, BusObjects may continue to
     // exist and be registered on BusAttachments even when they have no references.
-    std::unique_lock<std::mutex> lock(AllJoynBusObjectManager::ModifyBusObjectMap);
+    auto lock = shard.Lock.LockExclusive();
 
-    if (AllJoynBusObjectManager::BusObjectExists(busAttachment, objectPath))
+    auto range = shard.Entries.equal_range(hash);
+    for (auto entry = range.first; entry != range.second; entry++)
     {
-        std::tuple<alljoyn_busobject, bool, int>& busObjectEntry = (*AllJoynBusObjectManager::BusAttachmentMap[busAttachment])[objectPath];
-
-        // Decrement the reference counter for this entry.
-        std::get<2>(busObjectEntry)--;
-
-        // If there are no remaining references to this BusObject, unregister and destroy it.
-        if (0 == std::get<2>(busObjectEntry))
+        BusObjectEntry& busObjectEntry = entry->second;
+        if ((busObjectEntry.BusAttachment == busAttachment) && (busObjectEntry.ObjectPath == objectPath))
         {
-            return AllJoynBusObjectManager::UnregisterAndDestroyBusObject(busAttachment, objectPath);
+            // Decrement the reference counter for this entry.
+            busObjectEntry.ReferenceCount--;
+
+            // If there are no remaining references to this BusObject, unregister and destroy it, then remove its entry.
+            if (0 == busObjectEntry.ReferenceCount)
+            {
+                alljoyn_busattachment_unregisterbusobject(busAttachment, busObjectEntry.BusObject);
+                alljoyn_busobject_destroy(busObjectEntry.BusObject);
+                shard.Entries.erase(entry);
+            }
+            return ER_OK;
         }
-        return ER_OK;
     }
     return ER_OK;
 }
@@ -80,14 +95,20 @@ QStatus AllJoynBusObjectManager::ReleaseBusObject(_Inout_ alljoyn_busattachment
 QStatus AllJoynBusObjectManager::TryRegisterBusObject(_Inout_ alljoyn_busattachment busAttachment, _In_ const alljoyn_busobject busObject, _In_ const bool secure)
 {
     PCSTR objectPath = alljoyn_busobject_getpath(busObject);
+    size_t hash = AllJoynBusObjectManager::HashBusObject(busAttachment, objectPath);
+    BusObjectShard& shard = AllJoynBusObjectManager::BusObjectShards[hash % c_BusObjectShardCount];
+
+    // Hold the lock while registering so that the BusObject is registered at most once.
+    auto lock = shard.Lock.LockExclusive();
 
-    // To register this BusObject, it must first be created using GetBusObject so that a reference exists in BusAttachmentMap.
-    if (!AllJoynBusObjectManager::BusObjectExists(busAttachment, objectPath))
+    // To register this BusObject, it must first be created using GetBusObject so that a reference exists in BusObjectShards.
+    BusObjectEntry* busObjectEntry = AllJoynBusObjectManager::FindBusObject(shard, hash, busAttachment, objectPath);
+    if (nullptr == busObjectEntry)
     {
         return ER_BUS_OBJ_NOT_FOUND;
     }
 
-    if (!AllJoynBusObjectManager::BusObjectIsRegistered(busAttachment, busObject))
+    if (!busObjectEntry->IsRegistered)
     {
         if (secure)
         {
@@ -97,10 +118,9 @@ QStatus AllJoynBusObjectManager::TryRegisterBusObject(_Inout_ alljoyn_busattachm
         {
             RETURN_IF_QSTATUS_ERROR(alljoyn_busattachment_registerbusobject(busAttachment, busObject));
         }
-        std::tuple<alljoyn_busobject, bool, int>& busObjectEntry = (*AllJoynBusObjectManager::BusAttachmentMap[busAttachment])[objectPath];
 
         // Record that the BusObject in this entry has been registered with its associated BusAttachment.
-        std::get<1>(busObjectEntry) = true;
+        busObjectEntry->IsRegistered = true;
         return ER_OK;
     }
     return ER_OK;
@@ -108,19 +128,11 @@ QStatus AllJoynBusObjectManager::TryRegisterBusObject(_Inout_ alljoyn_busattachm
 
 bool AllJoynBusObjectManager::BusObjectExists(_In_ const alljoyn_busattachment busAttachment, _In_ const PCSTR objectPath)
 {
-    // If a BusObject map exists for this BusAttachment, search for an entry with the specified ObjectPath.
-    auto busObjectMapIterator = AllJoynBusObjectManager::BusAttachmentMap.find(busAttachment);
-    if (AllJoynBusObjectManager::BusAttachmentMap.end() != busObjectMapIterator)
-    {
-        auto existingBusObject = busObjectMapIterator->second->find(std::string(objectPath));
-        if (busObjectMapIterator->second->end() != existingBusObject)
-        {
-            return true;
-        }
-    }
+    size_t hash = AllJoynBusObjectManager::HashBusObject(busAttachment, objectPath);
+    BusObjectShard& shard = AllJoynBusObjectManager::BusObjectShards[hash % c_BusObjectShardCount];
 
-    // If nothing is found above, the specified BusObject has not been saved yet.
-    return false;
+    auto lock = shard.Lock.LockShared();
+    return nullptr != AllJoynBusObjectManager::FindBusObject(shard, hash, busAttachment, objectPath);
 }
 
 bool AllJoynBusObjectManager::BusObjectIsRegistered(_In_ const alljoyn_busattachment busAttachment, _In_ const alljoyn_busobject busObject)
@@ -131,12 +143,49 @@ bool AllJoynBusObjectManager::BusObjectIsRegistered(_In_ const alljoyn_busattach
     }
 
     PCSTR objectPath = alljoyn_busobject_getpath(busObject);
-    if (AllJoynBusObjectManager::BusObjectExists(busAttachment, objectPath))
+    size_t hash = AllJoynBusObjectManager::HashBusObject(busAttachment, objectPath);
+    BusObjectShard& shard = AllJoynBusObjectManager::BusObjectShards[hash % c_BusObjectShardCount];
+
+    auto lock = shard.Lock.LockShared();
+    BusObjectEntry* busObjectEntry = AllJoynBusObjectManager::FindBusObject(shard, hash, busAttachment, objectPath);
+    return (nullptr != busObjectEntry) && busObjectEntry->IsRegistered;
+}
+
+size_t AllJoynBusObjectManager::HashBusObject(_In_ const alljoyn_busattachment busAttachment, _In_ const PCSTR objectPath)
+{
+    // FNV-1a over the BusAttachment pointer followed by the ObjectPath. The 32-bit offset basis
+    // and prime are used when size_t is 32 bits, truncated 64-bit ones hash poorly.
+    const bool is32Bit = (sizeof(size_t) == 4);
+    size_t hash = is32Bit ? static_cast<size_t>(2166136261U) : static_cast<size_t>(14695981039346656037ULL);
+    const size_t prime = is32Bit ? static_cast<size_t>(16777619U) : static_cast<size_t>(1099511628211ULL);
+
+    uintptr_t attachment = reinterpret_cast<uintptr_t>(busAttachment);
+    for (size_t i = 0; i < sizeof(attachment); i++)
+    {
+        hash = (hash ^ ((attachment >> (i * 8)) & 0xFF)) * prime;
+    }
+    for (PCSTR c = objectPath; *c != '\0'; c++)
+    {
+        hash = (hash ^ static_cast<unsigned char>(*c)) * prime;
+    }
+
+    // Fold the high bits in, the shard is picked from the low bits.
+    return hash ^ (hash >> 16);
+}
+
+AllJoynBusObjectManager::BusObjectEntry* AllJoynBusObjectManager::FindBusObject(_In_ BusObjectShard& shard, _In_ size_t hash, _In_ const alljoyn_busattachment busAttachment, _In_ const PCSTR objectPath)
+{
+    auto range = shard.Entries.equal_range(hash);
+    for (auto entry = range.first; entry != range.second; entry++)
     {
-        std::tuple<alljoyn_busobject, bool, int> busObjectEntry = (*AllJoynBusObjectManager::BusAttachmentMap[busAttachment])[objectPath];
-        return std::get<1>(busObjectEntry);
+        if ((entry->second.BusAttachment == busAttachment) && (entry->second.ObjectPath == objectPath))
+        {
+            return &entry->second;
+        }
     }
-    return false;
+
+    // If nothing is found above, the specified BusObject has not been saved yet.
+    return nullptr;
 }
 
 QStatus AllJoynBusObjectManager::CreateBusObject(_In_ const PCSTR objectPath, _Out_ alljoyn_busobject* busObject)
@@ -155,51 +204,4 @@ QStatus AllJoynBusObjectManager::CreateBusObject(_In_ const PCSTR objectPath, _O
     }
     *busObject = newBusObject;
     return ER_OK;
-}
-
-QStatus AllJoynBusObjectManager::SaveBusObject(_In_ const alljoyn_busattachment busAttachment, _In_ const PCSTR objectPath, _In_ const alljoyn_busobject busObject)
-{
-    std::shared_ptr<std::map<std::string, std::tuple<alljoyn_busobject, bool, int>>> busObjectMap;
-
-    // Create a BusObject entry for this BusAttachment if it does not exist.
-    auto busObjectMapIterator = AllJoynBusObjectManager::BusAttachmentMap.find(busAttachment);
-    if (AllJoynBusObjectManager::BusAttachmentMap.end() != busObjectMapIterator)
-    {
-        busObjectMap = busObjectMapIterator->second;
-    }
-    else
-    {
-        busObjectMap = std::shared_ptr<std::map<std::string, std::tuple<alljoyn_busobject, bool, int>>> (
-            new std::map<std::string, std::tuple<alljoyn_busobject, bool, int>>);
-        AllJoynBusObjectManager::BusAttachmentMap.insert(std::make_pair(busAttachment, busObjectMap));
-    }
-
-    // Insert this BusObject into busObjectMap if it does not exist.
-    auto existingBusObject = busObjectMap->find(std::string(objectPath));
-    if (busObjectMap->end() == existingBusObject)
-    {
-        // Initialize the BusObject entry as "not registered" and with a single reference.
-        busObjectMap->insert(std::make_pair(std::string(objectPath), std::make_tuple(busObject, false, 1)));
-    }
-    return ER_OK;
-}
-
-QStatus AllJoynBusObjectManager::UnregisterAndDestroyBusObject(_Inout_ alljoyn_busattachment busAttachment, _In_ const PCSTR objectPath)
-{
-    if (AllJoynBusObjectManager::BusObjectExists(busAttachment, objectPath))
-    {
-        std::tuple<alljoyn_busobject, bool, int>& busObjectEntry = (*AllJoynBusObjectManager::BusAttachmentMap[busAttachment])[objectPath];
-
-        // Unregister and destroy the specified BusObject, then remove its entry from the containing map.
-        alljoyn_busattachment_unregisterbusobject(busAttachment, std::get<0>(busObjectEntry));
-        alljoyn_busobject_destroy(std::get<0>(busObjectEntry));
-        (*AllJoynBusObjectManager::BusAttachmentMap[busAttachment]).erase(objectPath);
-
-        // If the associated BusAttachment contains no more BusObjects, also remove the BusAttachment from BusAttachmentMap.
-        if (AllJoynBusObjectManager::BusAttachmentMap[busAttachment]->size() == 0)
-        {
-            AllJoynBusObjectManager::BusAttachmentMap.erase(busAttachment);
-        }
-    }
-    return ER_OK;
 }
\ No newline at end of file
@@ -50,24 +50,39 @@ public:
     // Determine whether the specified BusObject is registered on the specified BusAttachment.
     static bool BusObjectIsRegistered(_In_ const alljoyn_busattachment busAttachment, _In_ const alljoyn_busobject busObject);
 private:
-    // Lock public methods that result in modifications to BusAttachmentMap to ensure thread-safety.
-    static std::mutex ModifyBusObjectMap;
+    // A BusObject together with the BusAttachment and ObjectPath it is mapped to.
+    struct BusObjectEntry
+    {
+        alljoyn_busattachment BusAttachment;
+        std::string ObjectPath;
+        alljoyn_busobject BusObject;
 
-    // A nested map of BusObjects that is keyed first by BusAttachment, and then by ObjectPath, allowing a BusObject to be addressed 
-    // by its ObjectPath and the BusAttachment on which it is registered.
-    // Each innermost element (a tuple) contains three fields:
-    //   (0) The BusObject
-    //   (1) Whether the BusObject has been registered on the associated BusAttachment
-    //   (2) The number of references to the entry
-    static std::map<alljoyn_busattachment, std::shared_ptr<std::map<std::string, std::tuple<alljoyn_busobject, bool, int>>>> BusAttachmentMap;
+        // Whether the BusObject has been registered on the associated BusAttachment
+        bool IsRegistered;
 
-    // Create a BusObject that has no callbacks and uses the specified ObjectPath.
-    static QStatus CreateBusObject(_In_ const PCSTR objectPath, _Out_ alljoyn_busobject* busObject);
+        // The number of references to the entry
+        int ReferenceCount;
+    };
 
-    // Save the given BusObject in BusAttachmentMap, keyed by busAttachment and objectPath.
-    static QStatus SaveBusObject(_In_ const alljoyn_busattachment busAttachment, _In_ const PCSTR objectPath, _In_ const alljoyn_busobject busObject);
+    // The BusObjects are spread over several shards, each guarded by its own reader/writer lock, so that
+    // lookups only take a shared lock and operations on BusObjects in different shards never contend.
+    // Within a shard, entries are keyed by the hash of their BusAttachment and ObjectPath, which lets
+    // lookups find an entry straight from the PCSTR without building a std::string.
+    struct BusObjectShard
+    {
+        Microsoft::WRL::Wrappers::SRWLock Lock;
+        std::unordered_multimap<size_t, BusObjectEntry> Entries;
+    };
 
-    // If the BusObject is registered on the specified BusAttachment, unregister it. Then destroy the BusObject.
-    static QStatus UnregisterAndDestroyBusObject(_Inout_ alljoyn_busattachment busAttachment, _In_ const PCSTR objectPath);
-};
+    static const size_t c_BusObjectShardCount = 16;
+    static BusObjectShard BusObjectShards[c_BusObjectShardCount];
+
+    // Hash the BusAttachment and ObjectPath that address a BusObject. The hash also selects the shard.
+    static size_t HashBusObject(_In_ const alljoyn_busattachment busAttachment, _In_ const PCSTR objectPath);
 
+    // Find the entry for the given BusAttachment and ObjectPath in the shard. The caller must hold the shard's lock.
+    static BusObjectEntry* FindBusObject(_In_ BusObjectShard& shard, _In_ size_t hash, _In_ const alljoyn_busattachment busAttachment, _In_ const PCSTR objectPath);
+
+    // Create a BusObject that has no callbacks and uses the specified ObjectPath.
+    static QStatus CreateBusObject(_In_ const PCSTR objectPath, _Out_ alljoyn_busobject* busObject);
+};
@@ -31,64 +31,25 @@
 //-----------------------------------------------------------------------------
 #include "pch.h"
 
-_Check_return_ int32 TypeConversionHelpers::AppendNextCompleteType(_In_ PCSTR signature, _Out_ std::vector<char>* typeSignature)
+_Check_return_ int32 TypeConversionHelpers::GetDictionaryTypeSignatures(_In_ PCSTR signature, _Out_writes_z_(c_MaximumSignatureLength) char* keySignature, _Out_writes_z_(c_MaximumSignatureLength) char* valueSignature)
 {
-    if (signature[0] == '\0')
+    if ((signature[0] != 'a') || (signature[1] != '{'))
     {
         return ER_BUS_BAD_SIGNATURE;
     }
 
-    typeSignature->push_back(signature[0]);
-    if ((signature[0] == '(') || (signature[0] == '{'))
-    {
-        char openingParenthesis = signature[0];
-        char closingParenthesis = signature[0] == '(' ? ')' : '}';
-        // Find the matching closing parenthesis.
-        int openParenthesisCount = 1;
-        int index = 1;
-        while (openParenthesisCount > 0)
-        {
-            if ('\0' == signature[index])
-            {
-                return ER_BUS_BAD_SIGNATURE;
-            }
-
-            typeSignature->push_back(signature[index]);
-            if (openingParenthesis == signature[index])
-            {
-                openParenthesisCount++;
-            }
-            else if (closingParenthesis == signature[index])
-            {
-                openParenthesisCount--;
-            }
-            index++;
-        }
-        return S_OK;
-    }
-    else if (signature[0] == 'a')
-    {
-        return AppendNextCompleteType(signature + 1, typeSignature);
-    }
-    else
-    {
-        return S_OK;
-    }
-}
-
-_Check_return_ int32 TypeConversionHelpers::GetDictionaryTypeSignatures(_In_ PCSTR signature, _Out_ std::vector<char>* keySignature, _Out_ std::vector<char>* valueSignature)
-{
-    if ((strlen(signature) < 3) || (signature[0] != 'a') || (signature[1] != '{'))
+    // Skip past the opening "a{".
+    signature += 2;
+    size_t keyLength = AllJoynSignature::GetCompleteTypeLength(signature);
+    size_t valueLength = (keyLength == 0) ? 0 : AllJoynSignature::GetCompleteTypeLength(signature + keyLength);
+    if ((valueLength == 0) || (keyLength >= c_MaximumSignatureLength) || (valueLength >= c_MaximumSignatureLength))
     {
         return ER_BUS_BAD_SIGNATURE;
     }
 
-    // Skip past the opening "a{".
-    signature += 2;
-    RETURN_IF_QSTATUS_ERROR(AppendNextCompleteType(signature, keySignature));
-    signature += keySignature->size();
-    RETURN_IF_QSTATUS_ERROR(AppendNextCompleteType(signature, valueSignature));
-    keySignature->push_back('\0');
-    valueSignature->push_back('\0');
+    memcpy(keySignature, signature, keyLength);
+    keySignature[keyLength] = '\0';
+    memcpy(valueSignature, signature + keyLength, valueLength);
+    valueSignature[valueLength] = '\0';
     return ER_OK;
-}
+}
\ No newline at end of file
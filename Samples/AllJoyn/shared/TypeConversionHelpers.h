@@ -31,6 +31,55 @@
 //-----------------------------------------------------------------------------
 #pragma once
 
+// Parsing of AllJoyn type signatures.  The functions are constexpr so that signatures known at compile
+// time are parsed by the compiler, and they never allocate when parsing signatures at runtime.
+struct AllJoynSignature
+{
+    // Check whether the signature is an array of primitive values, such as "ai" or "ab".
+    static constexpr bool IsArrayOfPrimitives(_In_ PCSTR signature)
+    {
+        return (signature[0] == 'a') && (signature[1] != '\0') && (signature[2] == '\0') &&
+            (signature[1] != 's') && (signature[1] != 'v');
+    }
+
+    // Get the length of the complete type at the start of the given signature, or 0 if the signature is malformed.
+    //
+    // Examples:
+    //   If signature is "ii", the length is 1, because "i" describes the integer type
+    //   If signature is "a(is)si", the length is 5, because "a(is)" fully describes an array of structures.
+    static constexpr size_t GetCompleteTypeLength(_In_ PCSTR signature)
+    {
+        return (signature[0] == '\0') ? 0 :
+            (signature[0] == 'a') ? GetArrayTypeLength(GetCompleteTypeLength(signature + 1)) :
+            (signature[0] == '(') ? GetContainerTypeLength(signature, 1, ')') :
+            (signature[0] == '{') ? GetContainerTypeLength(signature, 1, '}') :
+            1;
+    }
+
+private:
+    static constexpr size_t GetArrayTypeLength(size_t elementLength)
+    {
+        return (elementLength == 0) ? 0 : elementLength + 1;
+    }
+
+    // Skip the members of a structure or dictionary entry, starting at offset, until the closing character.
+    static constexpr size_t GetContainerTypeLength(_In_ PCSTR signature, size_t offset, char closing)
+    {
+        return (signature[offset] == closing) ? offset + 1 :
+            GetContainerTypeLengthAfterMember(signature, offset, closing, GetCompleteTypeLength(signature + offset));
+    }
+
+    static constexpr size_t GetContainerTypeLengthAfterMember(_In_ PCSTR signature, size_t offset, char closing, size_t memberLength)
+    {
+        return (memberLength == 0) ? 0 : GetContainerTypeLength(signature, offset + memberLength, closing);
+    }
+};
+
+static_assert(AllJoynSignature::GetCompleteTypeLength("a(is)si") == 5, "Unexpected length for an array of structures");
+static_assert(AllJoynSignature::GetCompleteTypeLength("a{sv}") == 5, "Unexpected length for a dictionary");
+static_assert(AllJoynSignature::GetCompleteTypeLength("(i(ss)") == 0, "Unterminated structures must be rejected");
+static_assert(AllJoynSignature::IsArrayOfPrimitives("ai") && !AllJoynSignature::IsArrayOfPrimitives("as"), "Unexpected primitive array check");
+
 ref class TypeConversionHelpers
 {
 internal:
@@ -49,7 +98,8 @@ internal:
         }
         else
         {
-            *value = ref new Platform::Collections::Vector<T>(ref new Platform::Array<T>(arrayContents, static_cast<unsigned int>(elementCount)));
+            // Copy the values straight into the vector's storage.
+            *value = ref new Platform::Collections::Vector<T>(arrayContents, arrayContents + elementCount);
         }
 
         return ER_OK;
@@ -66,22 +116,25 @@ internal:
         return status;
     }
 
+    // Set an alljoyn_msgarg to an array of primitive values, copying all the values in one call.
+    template<class T>
+    static _Check_return_ int32 SetPrimitiveArrayMessageArg(_In_ alljoyn_msgarg argument, _In_ PCSTR signature, _In_ Windows::Foundation::Collections::IVectorView<T>^ value)
+    {
+        auto values = ref new Platform::Array<T>(value->Size);
+        value->GetMany(0, values);
+        return alljoyn_msgarg_set_and_stabilize(argument, signature, static_cast<size_t>(values->Length), values->Data);
+    }
+
     // Check whether the value passed in is an AllJoyn type signature for an array of primitive values,
     // such as an array of int32s or an array of booleans.
     static _Check_return_ bool IsArrayOfPrimitives(_In_ PCSTR signature)
     {
-        return (strlen(signature) == 2) && (signature[1] != 's') && (signature[1] != 'v');
+        return AllJoynSignature::IsArrayOfPrimitives(signature);
     }
 
-    // Find the next complete type in the given AllJoyn type signature and append it to typeSignature.
-    //
-    // Examples:
-    //   If signature is "ii", it will append "i", because that string describes the integer type
-    //   If signature is "a(is)si" it will append "a(is)", because that string fully describes an array of structures.
-    static _Check_return_ int32 AppendNextCompleteType(_In_ PCSTR signature, _Out_ std::vector<char>* typeSignature);
-
-    // Get the key and value types from the type AllJoyn type signature for a dictionary.
-    static _Check_return_ int32 GetDictionaryTypeSignatures(_In_ PCSTR signature, _Out_ std::vector<char>* keySignature, _Out_ std::vector<char>* valueSignature);
+    // Get the key and value types from the type AllJoyn type signature for a dictionary.  Both buffers must hold
+    // c_MaximumSignatureLength characters.
+    static _Check_return_ int32 GetDictionaryTypeSignatures(_In_ PCSTR signature, _Out_writes_z_(c_MaximumSignatureLength) char* keySignature, _Out_writes_z_(c_MaximumSignatureLength) char* valueSignature);
 
     // Get the value of an alljoyn_msgarg whose value matches WinRT type T.
     //
@@ -143,12 +196,16 @@ internal:
 
         if (arrayContents != nullptr)
         {
+            // Collect the elements first, appending them one by one to the WinRT vector is much slower.
+            std::vector<T> elements;
+            elements.reserve(elementCount);
             for (size_t i = 0; i < elementCount; i++)
             {
                 T elementValue;
                 RETURN_IF_QSTATUS_ERROR(GetAllJoynMessageArg(alljoyn_msgarg_array_element(arrayContents, i), elementSignature, &elementValue));
-                (*value)->Append(elementValue);
+                elements.push_back(elementValue);
             }
+            *value = ref new Platform::Collections::Vector<T>(std::move(elements));
         }
 
         return ER_OK;
@@ -162,16 +219,24 @@ internal:
             return ER_BUS_BAD_SIGNATURE;
         }
 
+        // AllJoyn booleans are 32-bit values, so arrays of booleans are converted element by element.
+        if (IsArrayOfPrimitives(signature) && (signature[1] != 'b'))
+        {
+            return SetPrimitiveArrayMessageArg(argument, signature, value);
+        }
+
         // Remove the 'a' to get the signature of an array element.
         PCSTR elementSignature = signature + 1;
-        alljoyn_msgarg arrayArgument = alljoyn_msgarg_array_create(value->Size);
+        auto elements = ref new Platform::Array<T>(value->Size);
+        value->GetMany(0, elements);
+        alljoyn_msgarg arrayArgument = alljoyn_msgarg_array_create(elements->Length);
 
-        for (size_t i = 0; i < value->Size; i++)
+        for (unsigned int i = 0; i < elements->Length; i++)
         {
-            RETURN_IF_QSTATUS_ERROR(SetAllJoynMessageArg(alljoyn_msgarg_array_element(arrayArgument, i), elementSignature, value->GetAt(static_cast<unsigned int>(i))));
+            RETURN_IF_QSTATUS_ERROR(SetAllJoynMessageArg(alljoyn_msgarg_array_element(arrayArgument, i), elementSignature, elements[i]));
         }
 
-        QStatus status = alljoyn_msgarg_set_and_stabilize(argument, "a*", (size_t)value->Size, arrayArgument);
+        QStatus status = alljoyn_msgarg_set_and_stabilize(argument, "a*", static_cast<size_t>(elements->Length), arrayArgument);
         alljoyn_msgarg_destroy(arrayArgument);
         return static_cast<int32>(status);
     }
@@ -193,20 +258,42 @@ internal:
 
     static _Check_return_ int32 SetAllJoynMessageArg(_In_ alljoyn_msgarg argument, _In_ PCSTR signature, _In_ Windows::Foundation::Collections::IVectorView<Platform::String^>^ value)
     {
-        std::vector<std::vector<char>> strings;
-        for (unsigned int i = 0; i < value->Size; i++)
+        auto strings = ref new Platform::Array<Platform::String^>(value->Size);
+        value->GetMany(0, strings);
+
+        // Convert all the strings into a single buffer.  A UTF-16 code unit never takes more than 3 bytes in UTF-8.
+        size_t bufferSize = 0;
+        for (unsigned int i = 0; i < strings->Length; i++)
         {
-            strings.push_back(AllJoynHelpers::PlatformToMultibyteString(value->GetAt(i)));
+            bufferSize += strings[i]->Length() * 3 + 1;
         }
 
         // alljoyn_msgarg_set expects the strings to be in the form of an array of char*.
-        std::vector<char*> allJoynArgument;
-        for (unsigned int i = 0; i < value->Size; i++)
+        std::vector<char> buffer(bufferSize);
+        std::vector<char*> allJoynArgument(strings->Length);
+        size_t offset = 0;
+        for (unsigned int i = 0; i < strings->Length; i++)
         {
-            allJoynArgument.push_back(strings.at(i).data());
+            int convertedBytes = 0;
+            if (strings[i]->Length() > 0)
+            {
+                convertedBytes = WideCharToMultiByte(
+                    CP_UTF8,
+                    WC_ERR_INVALID_CHARS,
+                    strings[i]->Data(),
+                    strings[i]->Length(),
+                    &buffer[offset],
+                    static_cast<int>(strings[i]->Length() * 3),
+                    nullptr,
+                    nullptr);
+            }
+
+            buffer[offset + convertedBytes] = '\0';
+            allJoynArgument[i] = &buffer[offset];
+            offset += strings[i]->Length() * 3 + 1;
         }
 
-        return alljoyn_msgarg_set_and_stabilize(argument, signature, value->Size, allJoynArgument.data());
+        return alljoyn_msgarg_set_and_stabilize(argument, signature, static_cast<size_t>(strings->Length), allJoynArgument.data());
     }
 
     static _Check_return_ int32 GetAllJoynMessageArg(_In_ alljoyn_msgarg argument, _In_ PCSTR signature, _Out_ Windows::Foundation::Collections::IVector<Platform::String^>^* value)
@@ -218,12 +305,15 @@ internal:
 
         if (arrayContents != nullptr)
         {
+            std::vector<Platform::String^> strings;
+            strings.reserve(elementCount);
             for (size_t i = 0; i < elementCount; i++)
             {
                 Platform::String^ elementValue;
                 RETURN_IF_QSTATUS_ERROR(GetAllJoynMessageArg(alljoyn_msgarg_array_element(arrayContents, i), "s", &elementValue));
-                (*value)->Append(elementValue);
+                strings.push_back(elementValue);
             }
+            *value = ref new Platform::Collections::Vector<Platform::String^>(std::move(strings));
         }
 
         return S_OK;
@@ -245,9 +335,9 @@ internal:
     template<class T, class U>
     static _Check_return_ int32 GetAllJoynMessageArg(_In_ alljoyn_msgarg argument, _In_ PCSTR signature, _Out_ Windows::Foundation::Collections::IMap<T, U>^* value)
     {
-        std::vector<char> keyType;
-        std::vector<char> valueType;
-        RETURN_IF_QSTATUS_ERROR(GetDictionaryTypeSignatures(signature, &keyType, &valueType));
+        char keyType[c_MaximumSignatureLength];
+        char valueType[c_MaximumSignatureLength];
+        RETURN_IF_QSTATUS_ERROR(GetDictionaryTypeSignatures(signature, keyType, valueType));
 
         *value = ref new Platform::Collections::Map<T, U>();
 
@@ -262,9 +352,9 @@ internal:
                 alljoyn_msgarg keyArg, valueArg;
                 RETURN_IF_QSTATUS_ERROR(alljoyn_msgarg_get(alljoyn_msgarg_array_element(dictionaryContents, i), "{**}", &keyArg, &valueArg));
                 T dictionaryKey;
-                RETURN_IF_QSTATUS_ERROR(GetAllJoynMessageArg(keyArg, keyType.data(), &dictionaryKey));
+                RETURN_IF_QSTATUS_ERROR(GetAllJoynMessageArg(keyArg, keyType, &dictionaryKey));
                 U dictionaryValue;
-                RETURN_IF_QSTATUS_ERROR(GetAllJoynMessageArg(valueArg, valueType.data(), &dictionaryValue));
+                RETURN_IF_QSTATUS_ERROR(GetAllJoynMessageArg(valueArg, valueType, &dictionaryValue));
 
                 (*value)->Insert(dictionaryKey, dictionaryValue);
             }
@@ -276,9 +366,9 @@ internal:
     template<class T>
     static _Check_return_ int32 GetAllJoynMessageArg(_In_ alljoyn_msgarg argument, _In_ PCSTR signature, _Out_ Windows::Foundation::Collections::IMap<T, Platform::Object^>^* value)
     {
-        std::vector<char> keyType;
-        std::vector<char> valueType;
-        RETURN_IF_QSTATUS_ERROR(GetDictionaryTypeSignatures(signature, &keyType, &valueType));
+        char keyType[c_MaximumSignatureLength];
+        char valueType[c_MaximumSignatureLength];
+        RETURN_IF_QSTATUS_ERROR(GetDictionaryTypeSignatures(signature, keyType, valueType));
 
         *value = ref new Platform::Collections::Map<T, Platform::Object^>();
 
@@ -293,7 +383,7 @@ internal:
                 alljoyn_msgarg keyArg, valueArg;
                 RETURN_IF_QSTATUS_ERROR(alljoyn_msgarg_get(alljoyn_msgarg_array_element(dictionaryContents, i), "{*v}", &keyArg, &valueArg));
                 T dictionaryKey;
-                RETURN_IF_QSTATUS_ERROR(GetAllJoynMessageArg(keyArg, keyType.data(), &dictionaryKey));
+                RETURN_IF_QSTATUS_ERROR(GetAllJoynMessageArg(keyArg, keyType, &dictionaryKey));
                 Platform::Object^ dictionaryValue;
                 RETURN_IF_QSTATUS_ERROR(GetValueFromVariant(valueArg, &dictionaryValue));
 
@@ -307,9 +397,9 @@ internal:
     template<class T, class U>
     static _Check_return_ int32 SetAllJoynMessageArg(_In_ alljoyn_msgarg argument, _In_ PCSTR signature, Windows::Foundation::Collections::IMapView<T, U>^ value)
     {
-        std::vector<char> keyType;
-        std::vector<char> valueType;
-        RETURN_IF_QSTATUS_ERROR(GetDictionaryTypeSignatures(signature, &keyType, &valueType));
+        char keyType[c_MaximumSignatureLength];
+        char valueType[c_MaximumSignatureLength];
+        RETURN_IF_QSTATUS_ERROR(GetDictionaryTypeSignatures(signature, keyType, valueType));
 
         alljoyn_msgarg dictionaryArg = alljoyn_msgarg_array_create(value->Size);
 
@@ -318,8 +408,8 @@ internal:
         {
             alljoyn_msgarg keyArg = alljoyn_msgarg_create();
             alljoyn_msgarg valueArg = alljoyn_msgarg_create();
-            RETURN_IF_QSTATUS_ERROR(SetAllJoynMessageArg(keyArg, keyType.data(), dictionaryElement->Key));
-            RETURN_IF_QSTATUS_ERROR(SetAllJoynMessageArg(valueArg, valueType.data(), dictionaryElement->Value));
+            RETURN_IF_QSTATUS_ERROR(SetAllJoynMessageArg(keyArg, keyType, dictionaryElement->Key));
+            RETURN_IF_QSTATUS_ERROR(SetAllJoynMessageArg(valueArg, valueType, dictionaryElement->Value));
 
             RETURN_IF_QSTATUS_ERROR(alljoyn_msgarg_set_and_stabilize(alljoyn_msgarg_array_element(dictionaryArg, i++), "{**}", keyArg, valueArg));
             alljoyn_msgarg_destroy(keyArg);
@@ -24,6 +24,8 @@ namespace DX
         float GetDPI() { return _logicalDPI; };
         void SetContentZoomFactor(float contentZoomFactor);
         float GetContentZoomFactor() { return _contentZoomFactor; };
+        // Physical pixels per DIP, including the content zoom factor
+        float GetScaleFactor() { return _dpiAdjustmentRatio; };
         void Trim();
 
         void GetUpdateRects(_Outptr_ RECT** ppUpdateRects, _Out_ ULONG* pUpdateRectsCount);
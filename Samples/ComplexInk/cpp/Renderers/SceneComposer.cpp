@@ -54,8 +54,7 @@ void SceneComposer::UpdateInk(Windows::Foundation::Collections::IVectorView<Wind
             strokesBoundingRect.Union(inkStroke->BoundingRect);
         }
         _inkRenderer->Update(inkStroke);
-        InkObject* inkObject = new InkObject(inkStroke);
-        _sceneObjects.push_back(inkObject);
+        AddSceneObject(new InkObject(inkStroke));
     }
 
     if (strokes->Size > 0)
@@ -89,8 +88,7 @@ void SceneComposer::UpdateShape()
     shapeRect.Width = shape.shape.right - shape.shape.left;
     shapeRect.Height = shape.shape.bottom - shape.shape.top;
 
-    SceneComposer::ShapeObject* shapeObject = new ShapeObject(shape);
-    _sceneObjects.push_back(shapeObject);
+    AddSceneObject(new ShapeObject(shape));
 
     assert(shapeRect.Width > 0 && shapeRect.Height > 0);
     assert(_deviceResources != nullptr);
@@ -120,6 +118,8 @@ void SceneComposer::ClearScene()
 
     DeleteSceneObjects();
     _sceneObjects.clear();
+    _sceneIndex.Clear();
+    _tileCache.InvalidateAll();
     _inkRenderer->Clear();
     _deviceResources->InvalidateContentRect();
 }
@@ -221,6 +221,8 @@ void SceneComposer::RemoveSelectedStrokesFromSceneObjects()
 
             if(inkObject->IsStrokeSelected())
             {
+                _sceneIndex.Remove(inkObject);
+                _tileCache.Invalidate(inkObject->getBounds());
                 pos = _sceneObjects.erase(pos);
                 delete inkObject;
                 continue;
@@ -262,14 +264,22 @@ void SceneComposer::DrawLasso(Windows::Foundation::Point pt)
     _deviceResources->InvalidateContentRect();
 }
 
-void SceneComposer::Render()
+void SceneComposer::AddSceneObject(SceneObject* sceneObject)
+{
+    // New objects go on top of the existing ones, both in the vector and in the index
+    _sceneObjects.push_back(sceneObject);
+    _sceneIndex.Insert(sceneObject, sceneObject->getBounds());
+    _tileCache.Invalidate(sceneObject->getBounds());
+}
+
+void SceneComposer::Render(std::vector<SceneObject*> const& sceneObjects)
 {
     auto strokes = ref new Platform::Collections::Vector<Windows::UI::Input::Inking::InkStroke^>;
-    for (unsigned int index = 0; index < _sceneObjects.size(); index++)
+    for (unsigned int index = 0; index < sceneObjects.size(); index++)
     {
-        if (_sceneObjects[index]->getType() == SOT_Ink)
+        if (sceneObjects[index]->getType() == SOT_Ink)
         {
-            InkObject* inkObject = dynamic_cast<InkObject*>(_sceneObjects[index]);
+            InkObject* inkObject = dynamic_cast<InkObject*>(sceneObjects[index]);
             if (inkObject != nullptr)
             {
                 auto currentInkStroke = inkObject->getStrokes();
@@ -282,17 +292,17 @@ void SceneComposer::Render()
                 // to optimize the rendering of ink. Once we find that the next object in the scene is different
                 // from ink or if we have reached the end of the vector, we pass the stroke collection to the 
                 // ink renderer.
-                if ((index == (_sceneObjects.size() - 1)) ||
-                    _sceneObjects[index + 1]->getType() == SOT_Shape)
+                if ((index == (sceneObjects.size() - 1)) ||
+                    sceneObjects[index + 1]->getType() == SOT_Shape)
                 {
                     _inkRenderer->Render(strokes, _deviceResources->GetD2DDeviceContext());
                     strokes->Clear();
                 }
             }
         }
-        else if (_sceneObjects[index]->getType() == SOT_Shape)
+        else if (sceneObjects[index]->getType() == SOT_Shape)
         {
-            ShapeObject* shape = dynamic_cast<ShapeObject*>(_sceneObjects[index]);
+            ShapeObject* shape = dynamic_cast<ShapeObject*>(sceneObjects[index]);
             if (shape != nullptr)
             {
                 _shapeRenderer->Render(shape->getShape(), _deviceResources->GetD2DDeviceContext());
@@ -311,6 +321,7 @@ void SceneComposer::RestoreDefaultStrokeSize()
         Windows::UI::Input::Inking::InkStroke^ inkStroke = inkStrokes->GetAt(i);
         if (inkStroke->Selected)
         {
+            _tileCache.Invalidate(InkObject::GetStrokeBounds(inkStroke));
             auto strokeDrawingAttributes = inkStroke->DrawingAttributes;
             strokeDrawingAttributes->Size = InkObject::GetDefaultStrokeSize();
             inkStroke->DrawingAttributes = strokeDrawingAttributes;
@@ -359,8 +370,7 @@ void SceneComposer::PasteSelected(Windows::Foundation::Point pastePosition)
         {
             if (inkStrokes->GetAt(i)->Selected)
             {
-                InkObject* inkObject = new InkObject(inkStrokes->GetAt(i));
-                _sceneObjects.push_back(inkObject);
+                AddSceneObject(new InkObject(inkStrokes->GetAt(i)));
             }
         }
         UnselectSceneObjects();
@@ -379,6 +389,12 @@ void SceneComposer::SelectInkSceneObject()
             InkObject* inkObject = dynamic_cast<InkObject*>(_sceneObjects[index]);
             if (inkObject != nullptr)
             {
+                // The stroke is drawn differently when it is or was selected
+                if (inkObject->IsStrokeSelected() || inkObject->HasHighlighterStroke())
+                {
+                    _tileCache.Invalidate(inkObject->getBounds());
+                }
+
                 assert(_inkRenderer != nullptr);
                 inkObject->SelectStroke(_inkRenderer->GetStrokeContainerForTemp());
 
@@ -447,7 +463,8 @@ HRESULT STDMETHODCALLTYPE SceneComposer::UpdatesNeeded()
         if (hr == D2DERR_RECREATE_TARGET ||
             hr == DXGI_ERROR_DEVICE_REMOVED)
         {
-            // HandleDeviceLost
+            // HandleDeviceLost. The tile bitmaps belong to the lost device.
+            _tileCache.Clear();
             _deviceResources->CreateDeviceResources();
 
             _deviceResources->InvalidateContentRect();
@@ -480,7 +497,16 @@ bool SceneComposer::Draw(_In_opt_ const RECT* pUpdateRect)
 
     _deviceResources->ClearTarget();
 
-    Render();
+    // BeginDraw draws the whole view for a missing or all zero update rect
+    if (pUpdateRect == nullptr ||
+        (pUpdateRect->left == 0 && pUpdateRect->top == 0 && pUpdateRect->right == 0 && pUpdateRect->bottom == 0))
+    {
+        Render(_sceneObjects);
+    }
+    else
+    {
+        DrawTiles(*pUpdateRect);
+    }
 
     if (_inLassoSelection)
     {
@@ -501,6 +527,69 @@ bool SceneComposer::Draw(_In_opt_ const RECT* pUpdateRect)
     return false;
 }
 
+void SceneComposer::DrawTiles(RECT const& updateRect)
+{
+    ID2D1DeviceContext* d2dContext = _deviceResources->GetD2DDeviceContext();
+    float scale = _deviceResources->GetScaleFactor();
+    float tileSize = TILE_SIZE / scale;
+
+    // Tiles are drawn with the same DPI as the surface, so they map 1:1 to its pixels
+    float dpiX, dpiY;
+    d2dContext->GetDpi(&dpiX, &dpiY);
+
+    // Keep the VSIS surface and its transform to restore them after drawing a tile
+    ComPtr<ID2D1Image> surface;
+    D2D1_MATRIX_3X2_F surfaceTransform;
+    d2dContext->GetTarget(&surface);
+    d2dContext->GetTransform(&surfaceTransform);
+
+    int left = static_cast<int>(floorf(static_cast<float>(updateRect.left) / TILE_SIZE));
+    int top = static_cast<int>(floorf(static_cast<float>(updateRect.top) / TILE_SIZE));
+    int right = static_cast<int>(floorf(static_cast<float>(updateRect.right - 1) / TILE_SIZE));
+    int bottom = static_cast<int>(floorf(static_cast<float>(updateRect.bottom - 1) / TILE_SIZE));
+
+    for (int y = top; y <= bottom; y++)
+    {
+        for (int x = left; x <= right; x++)
+        {
+            TileKey key = { x, y, scale };
+            D2D1_RECT_F bounds = D2D1::RectF(x * tileSize, y * tileSize, (x + 1) * tileSize, (y + 1) * tileSize);
+            Tile* tile = _tileCache.GetTile(key, bounds, TILE_SIZE * TILE_SIZE * 4);
+
+            if (!tile->valid)
+            {
+                if (tile->bitmap == nullptr)
+                {
+                    DX::ThrowIfFailed(d2dContext->CreateBitmap(
+                        D2D1::SizeU(TILE_SIZE, TILE_SIZE),
+                        nullptr,
+                        0,
+                        D2D1::BitmapProperties1(
+                            D2D1_BITMAP_OPTIONS_TARGET,
+                            D2D1::PixelFormat(DXGI_FORMAT_B8G8R8A8_UNORM, D2D1_ALPHA_MODE_PREMULTIPLIED),
+                            dpiX,
+                            dpiY),
+                        &tile->bitmap));
+                }
+
+                // Render the objects touching the tile into its bitmap
+                d2dContext->SetTarget(tile->bitmap.Get());
+                d2dContext->SetTransform(D2D1::Matrix3x2F::Translation(-bounds.left, -bounds.top));
+                _deviceResources->ClearTarget();
+
+                _sceneIndex.Query(bounds, _visibleObjects);
+                Render(_visibleObjects);
+
+                d2dContext->SetTarget(surface.Get());
+                d2dContext->SetTransform(surfaceTransform);
+                tile->valid = true;
+            }
+
+            d2dContext->DrawBitmap(tile->bitmap.Get(), bounds, 1.0f, D2D1_INTERPOLATION_MODE_NEAREST_NEIGHBOR);
+        }
+    }
+}
+
 HRESULT STDMETHODCALLTYPE SceneComposer::QueryInterface(
     REFIID uuid,
     _Outptr_ void** object
@@ -5,6 +5,8 @@
 #include "..\Common\DeviceResources.h"
 #include "InkRenderer.h"
 #include "ShapeRenderer.h"
+#include "SceneIndex.h"
+#include "TileCache.h"
 #include "WindowsNumerics.h"
 
 #define RECT_DELTA  3   // Inflate the invalidate rect to cover borderlines
@@ -60,6 +62,8 @@ namespace SDKTemplate
             }
         };
         void Trim() {
+            // Release the cached tiles, they are redrawn when needed
+            _tileCache.Clear();
             if (_deviceResources != nullptr) {
                 _deviceResources->Trim();
             };
@@ -103,7 +107,10 @@ namespace SDKTemplate
         class SceneObject
         {
         public:
+            virtual ~SceneObject() {};
             virtual SCENEOBJECT_TYPES getType() { return SCENEOBJECT_TYPES::SOT_Generic; };
+            // Rect covering everything the object draws, in DIPs
+            virtual D2D1_RECT_F getBounds() { return D2D1::RectF(); };
         };
 
         class InkObject : public SceneObject
@@ -129,7 +136,19 @@ namespace SDKTemplate
 
             virtual SCENEOBJECT_TYPES getType() { return SCENEOBJECT_TYPES::SOT_Ink; };
 
+            // The bounds are inflated by the selected stroke size, so they stay valid when the
+            // stroke is selected and drawn wider.
+            virtual D2D1_RECT_F getBounds() { return GetStrokeBounds(_stroke); };
+
+            static D2D1_RECT_F GetStrokeBounds(Windows::UI::Input::Inking::InkStroke^ stroke)
+            {
+                Windows::Foundation::Rect rect = stroke->BoundingRect;
+                float margin = GetSelectedStrokeSize();
+                return D2D1::RectF(rect.X - margin, rect.Y - margin, rect.X + rect.Width + margin, rect.Y + rect.Height + margin);
+            };
+
             bool IsStrokeSelected() { return _stroke->Selected; };
+            bool HasHighlighterStroke() { return _highlighterStroke != nullptr; };
             Windows::UI::Input::Inking::InkStroke^ GetInkStroke() { return _stroke; };
 
             // Retrieve the stroke with highlighter (for the "hollow" effect) if selected
@@ -192,13 +211,17 @@ namespace SDKTemplate
         public:
             ShapeObject(Shape s) : _shape(s) {};
             virtual SCENEOBJECT_TYPES getType() { return SCENEOBJECT_TYPES::SOT_Shape; };
+            virtual D2D1_RECT_F getBounds() { return _shape.shape; };
             Shape getShape() { return _shape; };
         private:
             Shape _shape;
         };
 
-        // Renders the cache of objects
-        void Render();
+        // Renders the given objects, which are in z-order
+        void Render(std::vector<SceneObject*> const& sceneObjects);
+        void AddSceneObject(SceneObject* sceneObject);
+        // Draws the update rect (in physical pixels) from the cached tiles, redrawing the invalid ones
+        void DrawTiles(RECT const& updateRect);
         void DeleteSceneObjects();
         void SelectInkSceneObject();
         void DeleteSelectedAndUpdate();
@@ -209,6 +232,14 @@ namespace SDKTemplate
         
         // This vector will contain all objects in the canvas (ink and shapes)
         std::vector<SceneObject*> _sceneObjects;
+        // Spatial index over the objects in _sceneObjects, so partial redraws only visit
+        // the objects intersecting the update rect
+        SceneIndex<SceneObject*> _sceneIndex;
+        // Objects found for the update rect being drawn, kept to reuse the allocation
+        std::vector<SceneObject*> _visibleObjects;
+        // Rasterized scene, so redrawing an unchanged area (when panning or scrolling) only
+        // copies bitmaps. Edits to the scene invalidate the tiles they touch.
+        TileCache _tileCache;
         std::unique_ptr<DX::DeviceResources> _deviceResources;
         std::unique_ptr<InkRenderer> _inkRenderer;
         std::unique_ptr<ShapeRenderer> _shapeRenderer;
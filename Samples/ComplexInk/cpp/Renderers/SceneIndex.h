@@ -0,0 +1,201 @@
+// Copyright (c) Microsoft. All rights reserved.
+
+#pragma once
+
+#include <algorithm>
+#include <unordered_map>
+#include <vector>
+
+#define SCENE_INDEX_CELL_SIZE       256.0f  // Size of a grid cell, in DIPs
+#define SCENE_INDEX_MAX_CELLS       64      // Objects covering more cells are kept in a separate list
+
+namespace SDKTemplate
+{
+    // Uniform grid over the bounding rects of the scene objects, used to find the objects
+    // that intersect an update rect without walking the whole scene. Each object is listed
+    // in every cell its rect overlaps, so inserting and removing only touch those cells.
+    // Objects are returned in the order they were inserted, which is their z-order.
+    // The index only depends on the object pointers and their rects, not on how the
+    // objects are drawn.
+    template <typename T>
+    class SceneIndex
+    {
+    public:
+        SceneIndex() : _nextZOrder(0), _queryStamp(0) {};
+
+        void Insert(T object, D2D1_RECT_F const& bounds)
+        {
+            assert(_entries.find(object) == _entries.end());
+
+            Entry& entry = _entries[object];
+            entry.object = object;
+            entry.bounds = bounds;
+            entry.zOrder = _nextZOrder++;
+            entry.queryStamp = _queryStamp;
+
+            CellRange range = GetCellRange(bounds);
+            if (range.Count() > SCENE_INDEX_MAX_CELLS)
+            {
+                _largeEntries.push_back(&entry);
+                return;
+            }
+
+            for (int y = range.top; y <= range.bottom; y++)
+            {
+                for (int x = range.left; x <= range.right; x++)
+                {
+                    _cells[CellKey(x, y)].push_back(&entry);
+                }
+            }
+        }
+
+        void Remove(T object)
+        {
+            auto pos = _entries.find(object);
+            if (pos == _entries.end())
+            {
+                return;
+            }
+
+            Entry* entry = &pos->second;
+            CellRange range = GetCellRange(entry->bounds);
+            if (range.Count() > SCENE_INDEX_MAX_CELLS)
+            {
+                RemoveFromList(_largeEntries, entry);
+            }
+            else
+            {
+                for (int y = range.top; y <= range.bottom; y++)
+                {
+                    for (int x = range.left; x <= range.right; x++)
+                    {
+                        auto cell = _cells.find(CellKey(x, y));
+                        assert(cell != _cells.end());
+                        RemoveFromList(cell->second, entry);
+                        if (cell->second.empty())
+                        {
+                            _cells.erase(cell);
+                        }
+                    }
+                }
+            }
+
+            _entries.erase(pos);
+        }
+
+        void Clear()
+        {
+            _entries.clear();
+            _cells.clear();
+            _largeEntries.clear();
+            _nextZOrder = 0;
+        }
+
+        // Replaces the content of results with the objects whose rect intersects rect, in z-order
+        void Query(D2D1_RECT_F const& rect, std::vector<T>& results)
+        {
+            results.clear();
+            _queryResults.clear();
+
+            // Objects spanning several cells are met once per cell, the stamp skips the repeats
+            _queryStamp++;
+
+            CellRange range = GetCellRange(rect);
+            for (int y = range.top; y <= range.bottom; y++)
+            {
+                for (int x = range.left; x <= range.right; x++)
+                {
+                    auto cell = _cells.find(CellKey(x, y));
+                    if (cell != _cells.end())
+                    {
+                        AddIntersecting(cell->second, rect);
+                    }
+                }
+            }
+            AddIntersecting(_largeEntries, rect);
+
+            std::sort(_queryResults.begin(), _queryResults.end(),
+                [](Entry const* a, Entry const* b) { return a->zOrder < b->zOrder; });
+
+            results.reserve(_queryResults.size());
+            for (Entry const* entry : _queryResults)
+            {
+                results.push_back(entry->object);
+            }
+        }
+
+        size_t Size() { return _entries.size(); };
+
+    private:
+        struct Entry
+        {
+            T object;
+            D2D1_RECT_F bounds;
+            unsigned long long zOrder;
+            unsigned int queryStamp;
+        };
+
+        // Inclusive range of cell coordinates
+        struct CellRange
+        {
+            int left;
+            int top;
+            int right;
+            int bottom;
+
+            int Count() const { return (right - left + 1) * (bottom - top + 1); };
+        };
+
+        static CellRange GetCellRange(D2D1_RECT_F const& rect)
+        {
+            CellRange range;
+            range.left = static_cast<int>(floorf(rect.left / SCENE_INDEX_CELL_SIZE));
+            range.top = static_cast<int>(floorf(rect.top / SCENE_INDEX_CELL_SIZE));
+            range.right = static_cast<int>(floorf(rect.right / SCENE_INDEX_CELL_SIZE));
+            range.bottom = static_cast<int>(floorf(rect.bottom / SCENE_INDEX_CELL_SIZE));
+            return range;
+        }
+
+        static long long CellKey(int x, int y)
+        {
+            return (static_cast<long long>(y) << 32) | static_cast<unsigned int>(x);
+        }
+
+        static bool Intersects(D2D1_RECT_F const& a, D2D1_RECT_F const& b)
+        {
+            return (a.left <= b.right) && (b.left <= a.right) && (a.top <= b.bottom) && (b.top <= a.bottom);
+        }
+
+        static void RemoveFromList(std::vector<Entry*>& list, Entry* entry)
+        {
+            // The order within a cell doesn't matter, queries sort by z-order
+            auto pos = std::find(list.begin(), list.end(), entry);
+            assert(pos != list.end());
+            *pos = list.back();
+            list.pop_back();
+        }
+
+        void AddIntersecting(std::vector<Entry*> const& list, D2D1_RECT_F const& rect)
+        {
+            for (Entry* entry : list)
+            {
+                if (entry->queryStamp != _queryStamp)
+                {
+                    entry->queryStamp = _queryStamp;
+                    if (Intersects(entry->bounds, rect))
+                    {
+                        _queryResults.push_back(entry);
+                    }
+                }
+            }
+        }
+
+        // Entries are node-based so the pointers kept in the cells stay valid
+        std::unordered_map<T, Entry> _entries;
+        std::unordered_map<long long, std::vector<Entry*>> _cells;
+        std::vector<Entry*> _largeEntries;
+        std::vector<Entry*> _queryResults;
+        unsigned long long _nextZOrder;
+        unsigned int _queryStamp;
+    };
+}
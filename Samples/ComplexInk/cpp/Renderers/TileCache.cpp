@@ -0,0 +1,90 @@
+// Copyright (c) Microsoft. All rights reserved.
+
+#include "pch.h"
+#include "TileCache.h"
+
+using namespace SDKTemplate;
+
+TileCache::TileCache(size_t budgetBytes) :
+    _budgetBytes(budgetBytes),
+    _memoryUsage(0),
+    _hitCount(0),
+    _missCount(0),
+    _evictionCount(0)
+{
+}
+
+Tile* TileCache::GetTile(TileKey const& key, D2D1_RECT_F const& bounds, size_t sizeBytes)
+{
+    auto pos = _tileMap.find(key);
+    if (pos != _tileMap.end())
+    {
+        // Move the tile to the front of the list, it is now the most recently used
+        _tiles.splice(_tiles.begin(), _tiles, pos->second);
+        Tile* tile = &_tiles.front();
+        if (tile->valid)
+        {
+            _hitCount++;
+        }
+        else
+        {
+            _missCount++;
+        }
+        return tile;
+    }
+
+    _missCount++;
+
+    Tile tile;
+    tile.key = key;
+    tile.bounds = bounds;
+    tile.sizeBytes = sizeBytes;
+    tile.valid = false;
+    _tiles.push_front(tile);
+    _tileMap[key] = _tiles.begin();
+    _memoryUsage += sizeBytes;
+
+    Evict();
+
+    return &_tiles.front();
+}
+
+void TileCache::Invalidate(D2D1_RECT_F const& rect)
+{
+    for (auto& tile : _tiles)
+    {
+        if (tile.bounds.left < rect.right && rect.left < tile.bounds.right &&
+            tile.bounds.top < rect.bottom && rect.top < tile.bounds.bottom)
+        {
+            tile.valid = false;
+        }
+    }
+}
+
+void TileCache::InvalidateAll()
+{
+    for (auto& tile : _tiles)
+    {
+        tile.valid = false;
+    }
+}
+
+void TileCache::Clear()
+{
+    _tiles.clear();
+    _tileMap.clear();
+    _memoryUsage = 0;
+}
+
+void TileCache::Evict()
+{
+    // Never evict the front tile, it is the one being returned
+    while (_memoryUsage > _budgetBytes && _tiles.size() > 1)
+    {
+        Tile& tile = _tiles.back();
+        _memoryUsage -= tile.sizeBytes;
+        _tileMap.erase(tile.key);
+        _tiles.pop_back();
+        _evictionCount++;
+    }
+}
@@ -0,0 +1,87 @@
+// Copyright (c) Microsoft. All rights reserved.
+
+#pragma once
+
+#include <list>
+#include <unordered_map>
+
+#define TILE_SIZE                   256                 // Width and height of a tile, in physical pixels
+#define TILE_CACHE_BUDGET           (64 * 1024 * 1024)  // Bytes of tile bitmaps kept before evicting
+
+namespace SDKTemplate
+{
+    // Identifies a tile: its position in the grid of TILE_SIZE pixel tiles at a given scale
+    // (DPI times zoom factor, relative to 96 DPI).
+    struct TileKey
+    {
+        int x;
+        int y;
+        float scale;
+
+        bool operator==(TileKey const& other) const
+        {
+            return x == other.x && y == other.y && scale == other.scale;
+        }
+    };
+
+    struct TileKeyHash
+    {
+        size_t operator()(TileKey const& key) const
+        {
+            size_t hash = std::hash<float>()(key.scale);
+            hash = hash * 31 + std::hash<int>()(key.x);
+            hash = hash * 31 + std::hash<int>()(key.y);
+            return hash;
+        }
+    };
+
+    // A cached raster of part of the scene.  A tile whose content changed keeps its bitmap but
+    // is marked invalid, so it can be redrawn without allocating a new one.
+    struct Tile
+    {
+        TileKey key;
+        D2D1_RECT_F bounds;                             // Area covered by the tile, in DIPs
+        size_t sizeBytes;
+        bool valid;
+        Microsoft::WRL::ComPtr<ID2D1Bitmap1> bitmap;
+    };
+
+    // Keeps the tile bitmaps of the scene, most recently used first.  When the memory used by
+    // the tiles goes over the budget the least recently used ones are released.  The cache
+    // only does the bookkeeping: creating and drawing the bitmaps is up to the caller.
+    class TileCache
+    {
+    public:
+        TileCache(size_t budgetBytes = TILE_CACHE_BUDGET);
+
+        // Returns the tile for the key, creating an invalid one without a bitmap if it is not
+        // cached.  The tile stays usable until the next call to GetTile, Invalidate or Clear.
+        Tile* GetTile(TileKey const& key, D2D1_RECT_F const& bounds, size_t sizeBytes);
+
+        // Marks the tiles intersecting rect (in DIPs) as needing to be redrawn, at all scales
+        void Invalidate(D2D1_RECT_F const& rect);
+        // Marks all tiles as needing to be redrawn
+        void InvalidateAll();
+        // Releases all tiles, for example when the device is lost
+        void Clear();
+
+        // Counters: tiles found valid, tiles that had to be drawn, and tiles released for the budget
+        unsigned int GetHitCount() { return _hitCount; };
+        unsigned int GetMissCount() { return _missCount; };
+        unsigned int GetEvictionCount() { return _evictionCount; };
+        size_t GetMemoryUsage() { return _memoryUsage; };
+        void ResetCounters() { _hitCount = 0; _missCount = 0; _evictionCount = 0; };
+
+    private:
+        void Evict();
+
+        std::list<Tile> _tiles;
+        std::unordered_map<TileKey, std::list<Tile>::iterator, TileKeyHash> _tileMap;
+        size_t _budgetBytes;
+        size_t _memoryUsage;
+
+        unsigned int _hitCount;
+        unsigned int _missCount;
+        unsigned int _evictionCount;
+    };
+}
@@ -2,6 +2,9 @@
 #include "MainPage.xaml.h"
 #include "SampleConfiguration.h"
 #include "CompressionUtils.h"
+#include <ppl.h>
+#include <atomic>
+#include <algorithm>
 
 using namespace Windows::Storage;
 using namespace Windows::Storage::Pickers;
@@ -122,3 +125,239 @@ task<size_t> ReadStreamTask::RunTask()
     return _Impl->RunTask();
 }
 #pragma endregion
+
+#pragma region Block mode implementation
+namespace
+{
+    // Compressor and decompressor handles can't be used by two threads at the same time, so
+    // every worker creates its own and reuses it for all the blocks it processes.
+    struct CompressorHolder
+    {
+        CompressorHolder(unsigned int Algorithm) : Handle(nullptr)
+        {
+            if (!CreateCompressor(Algorithm, nullptr, &Handle))
+            {
+                throw std::runtime_error("Cannot create compressor");
+            }
+        }
+
+        ~CompressorHolder()
+        {
+            CloseCompressor(Handle);
+        }
+
+        COMPRESSOR_HANDLE Handle;
+    };
+
+    struct DecompressorHolder
+    {
+        DecompressorHolder(unsigned int Algorithm) : Handle(nullptr)
+        {
+            if (!CreateDecompressor(Algorithm, nullptr, &Handle))
+            {
+                throw std::runtime_error("Cannot create decompressor");
+            }
+        }
+
+        ~DecompressorHolder()
+        {
+            CloseDecompressor(Handle);
+        }
+
+        DECOMPRESSOR_HANDLE Handle;
+    };
+
+    unsigned int GetWorkerCount(unsigned int WorkerCount, unsigned int BlockCount)
+    {
+        if (WorkerCount == 0)
+        {
+            WorkerCount = GetProcessorCount();
+        }
+        return (std::max)(1u, (std::min)(WorkerCount, BlockCount));
+    }
+
+    // Runs Work(Block) for every block on WorkerCount threads. Each worker takes the next block
+    // that nobody has started yet, so a slow block doesn't hold up the others.
+    template <typename Holder, typename Function>
+    void ForEachBlock(unsigned int Algorithm, unsigned int BlockCount, unsigned int WorkerCount, const Function &Work)
+    {
+        std::atomic<unsigned int> nextBlock(0);
+
+        parallel_for(0u, GetWorkerCount(WorkerCount, BlockCount), [&](unsigned int)
+        {
+            Holder holder(Algorithm);
+            for (unsigned int block = nextBlock++; block < BlockCount; block = nextBlock++)
+            {
+                Work(holder.Handle, block);
+            }
+        });
+    }
+
+    // Validates the header and index of a block mode stream and returns the header
+    const BlockStreamHeader &ReadBlockStreamHeader(const std::vector<byte> &Source)
+    {
+        if (Source.size() < sizeof(BlockStreamHeader))
+        {
+            throw std::runtime_error("Block stream is too small");
+        }
+
+        auto header = reinterpret_cast<const BlockStreamHeader *>(Source.data());
+        if ((header->Magic != BlockStreamMagic) || (header->Version != BlockStreamVersion) || (header->BlockSize == 0))
+        {
+            throw std::runtime_error("Unknown block stream format");
+        }
+
+        unsigned long long expectedBlocks = (header->OriginalSize + header->BlockSize - 1) / header->BlockSize;
+        if ((header->BlockCount != expectedBlocks) ||
+            ((Source.size() - sizeof(BlockStreamHeader)) / sizeof(BlockIndexEntry) < header->BlockCount))
+        {
+            throw std::runtime_error("Block stream index is truncated");
+        }
+
+        auto index = reinterpret_cast<const BlockIndexEntry *>(header + 1);
+        for (unsigned int block = 0; block < header->BlockCount; block++)
+        {
+            unsigned long long blockStart = static_cast<unsigned long long>(block) * header->BlockSize;
+            unsigned long long blockSize = std::min<unsigned long long>(header->BlockSize, header->OriginalSize - blockStart);
+
+            if ((index[block].OriginalSize != blockSize) ||
+                (index[block].Offset > Source.size()) ||
+                (index[block].CompressedSize > Source.size() - index[block].Offset))
+            {
+                throw std::runtime_error("Block stream index is corrupt");
+            }
+        }
+
+        return *header;
+    }
+
+    void DecompressBlock(DECOMPRESSOR_HANDLE Handle, const std::vector<byte> &Source, const BlockIndexEntry &Entry, byte *Destination)
+    {
+        SIZE_T decompressedSize = 0;
+        if (!Decompress(Handle,
+                        Source.data() + Entry.Offset,
+                        Entry.CompressedSize,
+                        Destination,
+                        Entry.OriginalSize,
+                        &decompressedSize) ||
+            (decompressedSize != Entry.OriginalSize))
+        {
+            throw std::runtime_error("Cannot decompress block");
+        }
+    }
+}
+
+size_t CompressBlocks(unsigned int Algorithm, const std::vector<byte> &Source, unsigned int BlockSize, unsigned int WorkerCount, std::vector<byte> &Destination)
+{
+    if (BlockSize == 0)
+    {
+        throw std::runtime_error("Block size must not be zero");
+    }
+
+    unsigned int blockCount = static_cast<unsigned int>((Source.size() + BlockSize - 1) / BlockSize);
+    std::vector<std::vector<byte>> compressedBlocks(blockCount);
+
+    ForEachBlock<CompressorHolder>(Algorithm, blockCount, WorkerCount, [&](COMPRESSOR_HANDLE Handle, unsigned int Block)
+    {
+        size_t blockStart = static_cast<size_t>(Block) * BlockSize;
+        size_t blockSize = std::min<size_t>(BlockSize, Source.size() - blockStart);
+        std::vector<byte> &compressed = compressedBlocks[Block];
+        SIZE_T compressedSize = 0;
+
+        // The first call returns the largest size the compressed block can have
+        if (!Compress(Handle, Source.data() + blockStart, blockSize, nullptr, 0, &compressedSize) &&
+            (GetLastError() != ERROR_INSUFFICIENT_BUFFER))
+        {
+            throw std::runtime_error("Cannot get compressed block size");
+        }
+
+        compressed.resize(compressedSize);
+        if (!Compress(Handle, Source.data() + blockStart, blockSize, compressed.data(), compressed.size(), &compressedSize))
+        {
+            throw std::runtime_error("Cannot compress block");
+        }
+        compressed.resize(compressedSize);
+    });
+
+    // Lay out the header, the index and then the blocks in order
+    size_t totalSize = sizeof(BlockStreamHeader) + blockCount * sizeof(BlockIndexEntry);
+    for (auto &compressed : compressedBlocks)
+    {
+        totalSize += compressed.size();
+    }
+
+    Destination.resize(totalSize);
+
+    auto header = reinterpret_cast<BlockStreamHeader *>(Destination.data());
+    header->Magic = BlockStreamMagic;
+    header->Version = BlockStreamVersion;
+    header->Algorithm = Algorithm;
+    header->BlockSize = BlockSize;
+    header->OriginalSize = Source.size();
+    header->BlockCount = blockCount;
+    header->Reserved = 0;
+
+    auto index = reinterpret_cast<BlockIndexEntry *>(header + 1);
+    size_t offset = sizeof(BlockStreamHeader) + blockCount * sizeof(BlockIndexEntry);
+    for (unsigned int block = 0; block < blockCount; block++)
+    {
+        std::vector<byte> &compressed = compressedBlocks[block];
+
+        index[block].Offset = offset;
+        index[block].CompressedSize = static_cast<unsigned int>(compressed.size());
+        index[block].OriginalSize = static_cast<unsigned int>(std::min<size_t>(BlockSize, Source.size() - static_cast<size_t>(block) * BlockSize));
+
+        memcpy(Destination.data() + offset, compressed.data(), compressed.size());
+        offset += compressed.size();
+    }
+
+    return Destination.size();
+}
+
+size_t DecompressBlocks(const std::vector<byte> &Source, unsigned int WorkerCount, std::vector<byte> &Destination, const std::vector<byte> *Original)
+{
+    const BlockStreamHeader &header = ReadBlockStreamHeader(Source);
+    auto index = reinterpret_cast<const BlockIndexEntry *>(&header + 1);
+
+    if ((Original != nullptr) && (Original->size() != header.OriginalSize))
+    {
+        throw std::runtime_error("Decompressed data size doesn't match original one");
+    }
+
+    Destination.resize(static_cast<size_t>(header.OriginalSize));
+
+    ForEachBlock<DecompressorHolder>(header.Algorithm, header.BlockCount, WorkerCount, [&](DECOMPRESSOR_HANDLE Handle, unsigned int Block)
+    {
+        size_t blockStart = static_cast<size_t>(Block) * header.BlockSize;
+        DecompressBlock(Handle, Source, index[Block], Destination.data() + blockStart);
+
+        // Verify the block while it is still in the cache
+        if ((Original != nullptr) &&
+            (memcmp(Destination.data() + blockStart, Original->data() + blockStart, index[Block].OriginalSize) != 0))
+        {
+            throw std::runtime_error("Decompressed data doesn't match original one");
+        }
+    });
+
+    return Destination.size();
+}
+
+unsigned long long DecompressBlockAt(const std::vector<byte> &Source, unsigned long long Position, std::vector<byte> &Destination)
+{
+    const BlockStreamHeader &header = ReadBlockStreamHeader(Source);
+    auto index = reinterpret_cast<const BlockIndexEntry *>(&header + 1);
+
+    if (Position >= header.OriginalSize)
+    {
+        throw std::runtime_error("Position is past the end of the data");
+    }
+
+    unsigned int block = static_cast<unsigned int>(Position / header.BlockSize);
+    DecompressorHolder holder(header.Algorithm);
+
+    Destination.resize(index[block].OriginalSize);
+    DecompressBlock(holder.Handle, Source, index[block], Destination.data());
+
+    return static_cast<unsigned long long>(block) * header.BlockSize;
+}
+#pragma endregion
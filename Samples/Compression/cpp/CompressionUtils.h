@@ -23,6 +23,47 @@ private:
     ReadStreamTaskImpl *_Impl;
 };
 
+// Block mode: the data is split into blocks of BlockSize bytes that are compressed independently
+// with the "classic" Compression API, so they can be compressed and decompressed in parallel and any
+// block can be decompressed on its own. The result is laid out as
+//     BlockStreamHeader
+//     BlockIndexEntry[BlockCount]     - where each compressed block starts and how large it is
+//     compressed blocks
+const unsigned int BlockStreamMagic = 0x5A4B4C42;          // "BLKZ"
+const unsigned int BlockStreamVersion = 1;
+const unsigned int DefaultBlockSize = 1024 * 1024;
+
+struct BlockStreamHeader
+{
+    unsigned int        Magic;
+    unsigned int        Version;
+    unsigned int        Algorithm;                          // COMPRESS_ALGORITHM_XXX
+    unsigned int        BlockSize;                          // Size of every block but the last one
+    unsigned long long  OriginalSize;
+    unsigned int        BlockCount;
+    unsigned int        Reserved;
+};
+
+struct BlockIndexEntry
+{
+    unsigned long long  Offset;                             // From the start of the stream
+    unsigned int        CompressedSize;
+    unsigned int        OriginalSize;
+};
+
+// Compresses Source into Destination and returns the size of the result. WorkerCount is the number
+// of threads compressing blocks at the same time, 0 uses one per processor. Throws std::runtime_error
+// on failure.
+size_t CompressBlocks(unsigned int Algorithm, const std::vector<byte> &Source, unsigned int BlockSize, unsigned int WorkerCount, std::vector<byte> &Destination);
+
+// Decompresses a whole block mode stream into Destination and returns its size. If Original is not
+// null every block is also compared with it as soon as it is decompressed.
+size_t DecompressBlocks(const std::vector<byte> &Source, unsigned int WorkerCount, std::vector<byte> &Destination, _In_opt_ const std::vector<byte> *Original = nullptr);
+
+// Decompresses the single block that contains offset Position of the original data into Destination,
+// which is resized to the block size. Returns the offset of the block in the original data.
+unsigned long long DecompressBlockAt(const std::vector<byte> &Source, unsigned long long Position, std::vector<byte> &Destination);
+
 // Common context for all scenarios for simplicity - not all fields are used by every scenario
 struct ScenarioContext
 {
@@ -17,6 +17,10 @@
 #include "Scenario1.xaml.h"
 #include "CompressionUtils.h"
 #include <robuffer.h>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
 
 using namespace Windows::UI::Xaml;
 using namespace Windows::UI::Xaml::Controls;
@@ -60,12 +64,52 @@ byte* GetUnderlyingBuffer(IBuffer^ buf)
     return raw_buffer;
 }
 
+// Number of buffers the compressor can write ahead of the decompressor before it has to wait
+const unsigned int PipeDepth = 4;
+
+// Bounded queue of buffers between PipeOut and PipeIn, so the compressor and the decompressor
+// run at the same time instead of taking turns. The time each side spends waiting for the
+// other is measured to show which one limits the pipe.
 struct PipeEvents {
-    task_completion_event<IBuffer^> on_write;
-    task_completion_event<void> on_read;
-    IBuffer^ unread_buffer;
-    unsigned int read_bytes;
+    PipeEvents(unsigned int depth) :
+        depth(depth),
+        closed(false),
+        read_bytes(0),
+        total_pipe_bytes(0),
+        writer_stall(0),
+        reader_stall(0)
+    {
+    }
+
+    // Called by either side once it stops using the pipe, whether it finished or failed.
+    // Reads past the end return what is left instead of waiting forever, and writes to a
+    // pipe whose reader is gone fail instead of waiting for room that never frees up.
+    void close()
+    {
+        lock_guard<mutex> lock(pipe_lock);
+        closed = true;
+        not_empty.notify_all();
+        not_full.notify_all();
+    }
+
+    mutex pipe_lock;
+    condition_variable not_empty;
+    condition_variable not_full;
+    deque<IBuffer^> buffers;
+    unsigned int depth;
+    bool closed;
+    unsigned int read_bytes;                // Bytes of buffers.front() already read
     unsigned long long total_pipe_bytes;
+    chrono::steady_clock::duration writer_stall;
+    chrono::steady_clock::duration reader_stall;
+};
+
+// Closes the pipe when one side of it is done, including when it throws
+struct PipeCloser {
+    PipeCloser(shared_ptr<PipeEvents> events) : events(events) {}
+    ~PipeCloser() { events->close(); }
+
+    shared_ptr<PipeEvents> events;
 };
 
 ref class PipeOut : IOutputStream 
@@ -81,10 +125,33 @@ public:
     {
         return create_async([this, buf](progress_reporter<unsigned int> reporter) -> unsigned int 
         {
+            if (buf->Length == 0)
+            {
+                return 0;
+            }
+
+            // The writer may reuse buf as soon as the write completes, so the pipe keeps its own
+            // copy. That copy is then handed over to the reader as is.
+            IBuffer^ pipe_buf = ref new Buffer(buf->Length);
+            memcpy(GetUnderlyingBuffer(pipe_buf), GetUnderlyingBuffer(buf), buf->Length);
+            pipe_buf->Length = buf->Length;
+
+            unique_lock<mutex> lock(events->pipe_lock);
+            if (events->buffers.size() >= events->depth)
+            {
+                auto start = chrono::steady_clock::now();
+                events->not_full.wait(lock, [this] { return events->buffers.size() < events->depth || events->closed; });
+                events->writer_stall += chrono::steady_clock::now() - start;
+            }
+
+            if (events->closed)
+            {
+                throw ref new Platform::COMException(HRESULT_FROM_WIN32(ERROR_BROKEN_PIPE));
+            }
+
+            events->buffers.push_back(pipe_buf);
             events->total_pipe_bytes += buf->Length;
-            events->on_write.set(buf);
-            create_task(events->on_read).wait();
-            events->on_read = task_completion_event<void>();
+            events->not_empty.notify_one();
             return buf->Length;
         });
     }
@@ -111,25 +178,50 @@ internal:
 public:
     virtual IAsyncOperationWithProgress<IBuffer^, unsigned int>^ ReadAsync(IBuffer^ buf, unsigned int count, InputStreamOptions options) 
     {
-        return create_async([this, buf, count](progress_reporter<unsigned int> reporter) -> IBuffer^ 
+        return create_async([this, buf, count, options](progress_reporter<unsigned int> reporter) -> IBuffer^ 
         {
+            bool partial = (options & InputStreamOptions::Partial) == InputStreamOptions::Partial;
+            unsigned int read_count = min(count, buf->Capacity);
             buf->Length = 0;
-            while (buf->Length < count) 
+
+            unique_lock<mutex> lock(events->pipe_lock);
+            while (buf->Length < read_count) 
             {
-                if (events->unread_buffer == nullptr) 
+                if (events->buffers.empty()) 
                 {
-                    events->unread_buffer = create_task(events->on_write).get();
-                    events->on_write = task_completion_event<IBuffer^>();
-                    events->read_bytes = 0;
+                    // A partial read completes with whatever has been read so far
+                    if (events->closed || (partial && buf->Length > 0))
+                    {
+                        break;
+                    }
+
+                    auto start = chrono::steady_clock::now();
+                    events->not_empty.wait(lock, [this] { return !events->buffers.empty() || events->closed; });
+                    events->reader_stall += chrono::steady_clock::now() - start;
+                    continue;
+                }
+
+                IBuffer^ front = events->buffers.front();
+
+                // A whole queued buffer that satisfies the read is returned instead of buf, the
+                // caller owns it from now on
+                if (buf->Length == 0 && events->read_bytes == 0 &&
+                    (front->Length == read_count || (partial && front->Length < read_count)))
+                {
+                    events->buffers.pop_front();
+                    events->not_full.notify_one();
+                    return front;
                 }
-                unsigned int to_copy = min(min(count, buf->Capacity) - buf->Length, events->unread_buffer->Length - events->read_bytes);
-                memcpy(GetUnderlyingBuffer(buf) + buf->Length, GetUnderlyingBuffer(events->unread_buffer) + events->read_bytes, to_copy);
+
+                unsigned int to_copy = min(read_count - buf->Length, front->Length - events->read_bytes);
+                memcpy(GetUnderlyingBuffer(buf) + buf->Length, GetUnderlyingBuffer(front) + events->read_bytes, to_copy);
                 buf->Length += to_copy;
                 events->read_bytes += to_copy;
-                if (events->read_bytes >= events->unread_buffer->Length) 
+                if (events->read_bytes >= front->Length) 
                 {
-                    events->unread_buffer = nullptr;
-                    events->on_read.set();
+                    events->buffers.pop_front();
+                    events->read_bytes = 0;
+                    events->not_full.notify_one();
                 }
             }
             return buf;
@@ -140,6 +232,16 @@ private:
     shared_ptr<PipeEvents> events;
 };
 
+// Results of the block mode pass
+struct BlockModeResult
+{
+    size_t          CompressedSize;
+    unsigned int    BlockCount;
+    unsigned int    WorkerCount;
+    double          CompressSeconds;
+    double          DecompressSeconds;
+};
+
 void ::SDKTemplate::Compression::Scenario1::DoScenario(CompressAlgorithm Algorithm)
 {
     Progress->Text = "";
@@ -148,8 +250,8 @@ void ::SDKTemplate::Compression::Scenario1::DoScenario(CompressAlgorithm Algorit
     auto picker = ref new Pickers::FileOpenPicker();
     picker->FileTypeFilter->Append("*");
 
-    auto events = make_shared<PipeEvents>();
-    events->total_pipe_bytes = 0;
+    auto context = make_shared<ScenarioContext>();
+    auto events = make_shared<PipeEvents>(PipeDepth);
 
     // First pick a test file and open it for reading
     create_task(picker->PickSingleFileAsync()).then([=](StorageFile^ OriginalFile)
@@ -161,10 +263,19 @@ void ::SDKTemplate::Compression::Scenario1::DoScenario(CompressAlgorithm Algorit
 
         Progress->Text += "File \"" + OriginalFile->Name + "\" has been picked\n";
 
-        return create_task(OriginalFile->OpenAsync(FileAccessMode::Read)) && create_task(OriginalFile->OpenAsync(FileAccessMode::Read));
+        return OriginalFile->OpenAsync(FileAccessMode::Read);
+    })
+
+    // Then read the whole file into memory, both passes below compress and verify from there
+    .then([=](IRandomAccessStream^ FileStream)
+    {
+        return ReadStreamTask(FileStream, context->originalData).RunTask();
+    })
 
-    }).then([=](vector<IRandomAccessStream^> FileStream) 
+    // Then compress it through a stream and decompress it on the other end of the pipe
+    .then([=](size_t BytesRead)
     {
+        Progress->Text += BytesRead.ToString() + " bytes have been read from disk\n";
 
         auto out_pipe = ref new PipeOut(events);
         auto in_pipe = ref new PipeIn(events);
@@ -187,16 +298,15 @@ void ::SDKTemplate::Compression::Scenario1::DoScenario(CompressAlgorithm Algorit
 
         return create_task([=]() 
         {
-            // Use a 1MB buffer to read file content in, compress, then decompress.
-            unsigned int total = 0;
+            PipeCloser closer(events);
+
+            // Feed the data to the compressor in 1MB chunks
+            size_t total = 0;
             IBuffer^ buf = ref new Buffer(1024 * 1024);
-            for (;;) 
+            while (total < context->originalData.size()) 
             {
-                create_task(FileStream[0]->ReadAsync(buf, buf->Capacity, InputStreamOptions::None)).wait();
-                if (buf->Length == 0) 
-                {
-                    break;
-                }
+                buf->Length = static_cast<unsigned int>(min(static_cast<size_t>(buf->Capacity), context->originalData.size() - total));
+                memcpy(GetUnderlyingBuffer(buf), context->originalData.data() + total, buf->Length);
                 total += buf->Length;
                 create_task(compressor->WriteAsync(buf)).wait();
             }
@@ -205,9 +315,10 @@ void ::SDKTemplate::Compression::Scenario1::DoScenario(CompressAlgorithm Algorit
         }) &&
             create_task([=]() 
             {
-                unsigned int total = 0;
+                PipeCloser closer(events);
+
+                size_t total = 0;
                 IBuffer^ buf = ref new Buffer(256 * 1024);
-                IBuffer^ file_buf = ref new Buffer(buf->Capacity);
                 for (;;) 
                 {
                     create_task(decompressor->ReadAsync(buf, buf->Capacity, InputStreamOptions::Partial)).wait();
@@ -216,13 +327,12 @@ void ::SDKTemplate::Compression::Scenario1::DoScenario(CompressAlgorithm Algorit
                         break;
                     }
 
-                    create_task(FileStream[1]->ReadAsync(file_buf, buf->Length, InputStreamOptions::None)).wait();
-                    if (file_buf->Length != buf->Length) 
+                    if (buf->Length > context->originalData.size() - total) 
                     {
                         throw runtime_error("unexpected read length");
                     }
 
-                    if (memcmp(GetUnderlyingBuffer(buf), GetUnderlyingBuffer(file_buf), buf->Length) != 0) 
+                    if (memcmp(GetUnderlyingBuffer(buf), context->originalData.data() + total, buf->Length) != 0) 
                     {
                         throw runtime_error("compression mismatch!");
                     }
@@ -232,17 +342,66 @@ void ::SDKTemplate::Compression::Scenario1::DoScenario(CompressAlgorithm Algorit
         });
     })
 
-    .then([=](task<vector<unsigned int> > x) 
+    // Then do the same in block mode: independent blocks compressed and decompressed on all processors
+    .then([=](vector<size_t> Totals) 
     {
-        try {
-            if (x.get()[0] != x.get()[1]) {
-                rootPage->NotifyUser("size mismatch", NotifyType::ErrorMessage);
-            } 
-            else 
+        if (Totals[0] != Totals[1]) 
+        {
+            throw runtime_error("size mismatch");
+        }
+
+        Progress->Text += "Stream mode: original size " + Totals[0].ToString() + ", compressed size " + events->total_pipe_bytes.ToString() + "\n";
+        Progress->Text += "Stream mode: compressor waited " +
+            static_cast<long long>(chrono::duration_cast<chrono::milliseconds>(events->writer_stall).count()).ToString() + " ms for the pipe, decompressor waited " +
+            static_cast<long long>(chrono::duration_cast<chrono::milliseconds>(events->reader_stall).count()).ToString() + " ms\n";
+
+        return task<BlockModeResult>([=]()
+        {
+            // Enumaration values of Windows::Storage::Compression::CompressAlgorithm are
+            // guaranteed to match values from compressapi.h. Compress algorithm should always
+            // be explicit for "classic" Compression API
+            unsigned int compressAlgorithm = static_cast<unsigned int>(Algorithm);
+            if (compressAlgorithm == COMPRESS_ALGORITHM_INVALID || compressAlgorithm == COMPRESS_ALGORITHM_NULL)
             {
-                Progress->Text += "Original size: " + x.get()[0] + "\nCompressed size: " + events->total_pipe_bytes + "\n";
-                rootPage->NotifyUser("Done", NotifyType::StatusMessage);
+                compressAlgorithm = COMPRESS_ALGORITHM_XPRESS;
             }
+
+            BlockModeResult result;
+            result.BlockCount = static_cast<unsigned int>((context->originalData.size() + DefaultBlockSize - 1) / DefaultBlockSize);
+            result.WorkerCount = max(1u, min(GetProcessorCount(), result.BlockCount));
+
+            auto start = chrono::steady_clock::now();
+            result.CompressedSize = CompressBlocks(compressAlgorithm, context->originalData, DefaultBlockSize, 0, context->compressedData);
+            auto compressed = chrono::steady_clock::now();
+            DecompressBlocks(context->compressedData, 0, context->decompressedData, &context->originalData);
+            auto decompressed = chrono::steady_clock::now();
+
+            result.CompressSeconds = chrono::duration<double>(compressed - start).count();
+            result.DecompressSeconds = chrono::duration<double>(decompressed - compressed).count();
+            return result;
+        });
+    })
+
+    .then([=](BlockModeResult Result)
+    {
+        double megabytes = context->originalData.size() / (1024.0 * 1024.0);
+
+        Progress->Text += "Block mode: " + Result.BlockCount.ToString() + " blocks on " + Result.WorkerCount.ToString() + " threads, compressed size " + Result.CompressedSize.ToString() + "\n";
+        if (Result.CompressSeconds > 0 && Result.DecompressSeconds > 0)
+        {
+            Progress->Text += "Block mode: compressed at " + static_cast<int>(megabytes / Result.CompressSeconds).ToString() +
+                " MB/s, decompressed and verified at " + static_cast<int>(megabytes / Result.DecompressSeconds).ToString() + " MB/s\n";
+        }
+    })
+
+    // Final task based continuation is used to handle exceptions in the chain above
+    .then([=](task<void> FinalContinuation) 
+    {
+        try {
+            // Transport all exceptions to this thread. This task is guaranteed to be completed by now.
+            FinalContinuation.get();
+
+            rootPage->NotifyUser("Done", NotifyType::StatusMessage);
         } 
         catch (Platform::Exception ^e) 
         {
@@ -16,6 +16,90 @@ using namespace Windows::Foundation;
 using namespace Windows::ApplicationModel;
 using namespace concurrency;
 
+MappedFileData::MappedFileData(
+    _In_ Platform::String^ path
+    ) :
+    m_file(INVALID_HANDLE_VALUE),
+    m_data(nullptr),
+    m_length(0)
+{
+    CREATEFILE2_EXTENDED_PARAMETERS extendedParams = {0};
+    extendedParams.dwSize = sizeof(CREATEFILE2_EXTENDED_PARAMETERS);
+    extendedParams.dwFileAttributes = FILE_ATTRIBUTE_NORMAL;
+    extendedParams.dwFileFlags = FILE_FLAG_SEQUENTIAL_SCAN;
+    extendedParams.dwSecurityQosFlags = SECURITY_ANONYMOUS;
+    extendedParams.lpSecurityAttributes = nullptr;
+    extendedParams.hTemplateFile = nullptr;
+
+    m_file.Attach(
+        CreateFile2(
+            path->Data(),
+            GENERIC_READ,
+            FILE_SHARE_READ,
+            OPEN_EXISTING,
+            &extendedParams
+            )
+        );
+    if (!m_file.IsValid())
+    {
+        throw ref new Platform::FailureException();
+    }
+
+    FILE_STANDARD_INFO fileInfo = {0};
+    if (!GetFileInformationByHandleEx(
+        m_file.Get(),
+        FileStandardInfo,
+        &fileInfo,
+        sizeof(fileInfo)
+        ))
+    {
+        throw ref new Platform::FailureException();
+    }
+
+    // Empty files can't be mapped and no asset format is larger than 4 GB.
+    if (fileInfo.EndOfFile.QuadPart == 0 || fileInfo.EndOfFile.HighPart != 0)
+    {
+        throw ref new Platform::FailureException();
+    }
+    m_length = fileInfo.EndOfFile.LowPart;
+
+    m_mapping.Attach(
+        CreateFileMappingFromApp(
+            m_file.Get(),
+            nullptr,
+            PAGE_READONLY,
+            0,
+            nullptr
+            )
+        );
+    if (!m_mapping.IsValid())
+    {
+        throw ref new Platform::FailureException();
+    }
+
+    m_data = static_cast<byte*>(
+        MapViewOfFileFromApp(
+            m_mapping.Get(),
+            FILE_MAP_READ,
+            0,
+            0
+            )
+        );
+    if (m_data == nullptr)
+    {
+        throw ref new Platform::FailureException();
+    }
+}
+
+MappedFileData::~MappedFileData()
+{
+    if (m_data != nullptr)
+    {
+        UnmapViewOfFile(m_data);
+        m_data = nullptr;
+    }
+}
+
 BasicReaderWriter::BasicReaderWriter()
 {
     m_location = Package::Current->InstalledLocation;
@@ -110,6 +194,23 @@ task<Platform::Array<byte>^> BasicReaderWriter::ReadDataAsync(
     });
 }
 
+MappedFileData^ BasicReaderWriter::MapData(
+    _In_ Platform::String^ filename
+    )
+{
+    return ref new MappedFileData(m_location->Path + "\\" + filename);
+}
+
+task<MappedFileData^> BasicReaderWriter::MapDataAsync(
+    _In_ Platform::String^ filename
+    )
+{
+    return create_task([=]()
+    {
+        return MapData(filename);
+    });
+}
+
 uint32 BasicReaderWriter::WriteData(
     _In_ Platform::String^ filename,
     _In_ const Platform::Array<byte>^ fileData
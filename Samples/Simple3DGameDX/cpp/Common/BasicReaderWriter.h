@@ -9,6 +9,35 @@
 
 #include <ppltasks.h>
 
+// A read-only view of a whole file mapped into memory.  The pages are read from
+// disk as they are first touched, so the data is never copied into a separate
+// buffer.  The view is unmapped when the object is destroyed.
+ref class MappedFileData sealed
+{
+internal:
+    MappedFileData(
+        _In_ Platform::String^ path
+        );
+
+    property byte* Data
+    {
+        byte* get() { return m_data; }
+    }
+
+    property uint32 Length
+    {
+        uint32 get() { return m_length; }
+    }
+
+private:
+    ~MappedFileData();
+
+    Microsoft::WRL::Wrappers::FileHandle m_file;
+    Microsoft::WRL::Wrappers::HandleT<Microsoft::WRL::Wrappers::HandleTraits::HANDLENullTraits> m_mapping;
+    byte* m_data;
+    uint32 m_length;
+};
+
 // A simple reader/writer class that provides support for reading and writing
 // files on disk. Provides synchronous and asynchronous methods.
 ref class BasicReaderWriter
@@ -30,6 +59,16 @@ internal:
         _In_ Platform::String^ filename
         );
 
+    // Maps the file into memory.  The async version opens and maps the file on a
+    // thread pool thread, and its continuations run there too by default.
+    MappedFileData^ MapData(
+        _In_ Platform::String^ filename
+        );
+
+    concurrency::task<MappedFileData^> MapDataAsync(
+        _In_ Platform::String^ filename
+        );
+
     uint32 WriteData(
         _In_ Platform::String^ filename,
         _In_ const Platform::Array<byte>^ fileData
@@ -943,7 +943,8 @@ static void CreateTextureFromDDS(
     _In_ unsigned int miscFlags,
     _In_ bool forceSRGB,
     _Outptr_opt_ ID3D11Resource** texture,
-    _Outptr_opt_ ID3D11ShaderResourceView** textureView
+    _Outptr_opt_ ID3D11ShaderResourceView** textureView,
+    _Inout_opt_ DDSTextureLayout* layout
     )
 {
     HRESULT hr = S_OK;
@@ -1150,6 +1151,28 @@ static void CreateTextureFromDDS(
     }
 
     DX::ThrowIfFailed(hr);
+
+    if (layout)
+    {
+        // Remember what was actually created, so the next load can create it directly
+        layout->resDim = resDim;
+        layout->width = twidth;
+        layout->height = theight;
+        layout->depth = tdepth;
+        layout->mipCount = mipCount - skipMip;
+        layout->arraySize = arraySize;
+        layout->format = forceSRGB ? MakeSRGB(format) : format;
+        layout->isCubeMap = isCubeMap;
+
+        layout->subresources.resize(layout->mipCount * arraySize);
+        for (size_t i = 0; i < layout->subresources.size(); i++)
+        {
+            // Relative to the pixel data for now, the caller adds the header size
+            layout->subresources[i].offset = static_cast<const byte*>(initData[i].pSysMem) - bitData;
+            layout->subresources[i].rowPitch = initData[i].SysMemPitch;
+            layout->subresources[i].slicePitch = initData[i].SysMemSlicePitch;
+        }
+    }
 }
 
 
@@ -1204,20 +1227,20 @@ void CreateDDSTextureFromMemory(
 
 
 //--------------------------------------------------------------------------------------
-_Use_decl_annotations_
-void CreateDDSTextureFromMemoryEx(
-    ID3D11Device* d3dDevice,
-    const uint8_t* ddsData,
-    size_t ddsDataSize,
-    size_t maxsize,
-    D3D11_USAGE usage,
-    unsigned int bindFlags,
-    unsigned int cpuAccessFlags,
-    unsigned int miscFlags,
-    bool forceSRGB,
-    ID3D11Resource** texture,
-    ID3D11ShaderResourceView** textureView,
-    D2D1_ALPHA_MODE* alphaMode
+static void LoadDDSTextureFromMemory(
+    _In_ ID3D11Device* d3dDevice,
+    _In_reads_bytes_(ddsDataSize) const uint8_t* ddsData,
+    _In_ size_t ddsDataSize,
+    _In_ size_t maxsize,
+    _In_ D3D11_USAGE usage,
+    _In_ unsigned int bindFlags,
+    _In_ unsigned int cpuAccessFlags,
+    _In_ unsigned int miscFlags,
+    _In_ bool forceSRGB,
+    _Outptr_opt_ ID3D11Resource** texture,
+    _Outptr_opt_ ID3D11ShaderResourceView** textureView,
+    _Out_opt_ D2D1_ALPHA_MODE* alphaMode,
+    _Inout_opt_ DDSTextureLayout* layout
     )
 {
     if (texture)
@@ -1275,8 +1298,119 @@ void CreateDDSTextureFromMemoryEx(
 
     ptrdiff_t offset = sizeof(uint32) + sizeof(DDS_HEADER) + (bDXT10Header ? sizeof(DDS_HEADER_DXT10) : 0);
 
-    CreateTextureFromDDS(d3dDevice, header, ddsData + offset, ddsDataSize - offset, maxsize, usage, bindFlags, cpuAccessFlags, miscFlags, forceSRGB, texture, textureView);
+    CreateTextureFromDDS(d3dDevice, header, ddsData + offset, ddsDataSize - offset, maxsize, usage, bindFlags, cpuAccessFlags, miscFlags, forceSRGB, texture, textureView, layout);
 
     if (alphaMode)
         *alphaMode = GetAlphaMode(header);
+
+    if (layout)
+    {
+        for (size_t i = 0; i < layout->subresources.size(); i++)
+        {
+            layout->subresources[i].offset += offset;
+        }
+
+        layout->dataSize = ddsDataSize;
+        layout->header.assign(ddsData, ddsData + offset);
+        layout->featureLevel = d3dDevice->GetFeatureLevel();
+        layout->alphaMode = GetAlphaMode(header);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------
+_Use_decl_annotations_
+void CreateDDSTextureFromMemoryEx(
+    ID3D11Device* d3dDevice,
+    const uint8_t* ddsData,
+    size_t ddsDataSize,
+    size_t maxsize,
+    D3D11_USAGE usage,
+    unsigned int bindFlags,
+    unsigned int cpuAccessFlags,
+    unsigned int miscFlags,
+    bool forceSRGB,
+    ID3D11Resource** texture,
+    ID3D11ShaderResourceView** textureView,
+    D2D1_ALPHA_MODE* alphaMode
+    )
+{
+    LoadDDSTextureFromMemory(d3dDevice, ddsData, ddsDataSize, maxsize, usage, bindFlags, cpuAccessFlags, miscFlags, forceSRGB, texture, textureView, alphaMode, nullptr);
+}
+
+
+//--------------------------------------------------------------------------------------
+_Use_decl_annotations_
+void CreateDDSTextureFromMemoryWithLayout(
+    ID3D11Device* d3dDevice,
+    const byte* ddsData,
+    size_t ddsDataSize,
+    DDSTextureLayout* layout,
+    ID3D11Resource** texture,
+    ID3D11ShaderResourceView** textureView
+    )
+{
+    if (!layout)
+    {
+        throw ref new Platform::InvalidArgumentException();
+    }
+
+    // The layout only applies to the file it was made from.  Comparing the headers and the
+    // size is enough to tell, the pixel data itself doesn't change the layout.
+    bool layoutValid =
+        !layout->header.empty() &&
+        layout->dataSize == ddsDataSize &&
+        layout->featureLevel == d3dDevice->GetFeatureLevel() &&
+        memcmp(layout->header.data(), ddsData, layout->header.size()) == 0;
+
+    if (!layoutValid)
+    {
+        layout->header.clear();
+        LoadDDSTextureFromMemory(d3dDevice, ddsData, ddsDataSize, 0, D3D11_USAGE_DEFAULT, D3D11_BIND_SHADER_RESOURCE, 0, 0, false, texture, textureView, nullptr, layout);
+        return;
+    }
+
+    if (texture)
+    {
+        *texture = nullptr;
+    }
+    if (textureView)
+    {
+        *textureView = nullptr;
+    }
+
+    if (!texture && !textureView)
+    {
+        throw ref new Platform::InvalidArgumentException();
+    }
+
+    std::unique_ptr<D3D11_SUBRESOURCE_DATA[]> initData(new D3D11_SUBRESOURCE_DATA[layout->subresources.size()]);
+    for (size_t i = 0; i < layout->subresources.size(); i++)
+    {
+        initData[i].pSysMem = ddsData + layout->subresources[i].offset;
+        initData[i].SysMemPitch = layout->subresources[i].rowPitch;
+        initData[i].SysMemSlicePitch = layout->subresources[i].slicePitch;
+    }
+
+    DX::ThrowIfFailed(
+        CreateD3DResources(
+            d3dDevice,
+            layout->resDim,
+            layout->width,
+            layout->height,
+            layout->depth,
+            layout->mipCount,
+            layout->arraySize,
+            layout->format,
+            D3D11_USAGE_DEFAULT,
+            D3D11_BIND_SHADER_RESOURCE,
+            0,
+            0,
+            false,
+            layout->isCubeMap,
+            initData.get(),
+            texture,
+            textureView
+            )
+        );
 }
@@ -36,6 +36,8 @@ GameRenderer::GameRenderer(const std::shared_ptr<DX::DeviceResources>& deviceRes
     m_gameResourcesLoaded(false),
     m_levelResourcesLoaded(false)
 {
+    m_renderList = ref new RenderList();
+
     m_gameHud = ref new GameHud(
         deviceResources,
         "Windows platform samples",
@@ -484,6 +486,25 @@ void GameRenderer::Render()
         renderingPasses = 2;
     }
 
+    if (m_game != nullptr && m_gameResourcesLoaded && m_levelResourcesLoaded)
+    {
+        // Cull and sort the objects once for all the rendering passes.  The orientation
+        // transform only rotates the clip space by multiples of 90 degrees, so it doesn't
+        // change which objects are visible.
+        XMMATRIX view = m_game->GameCamera()->View();
+        XMFLOAT4X4 viewProjections[2];
+        if (stereoEnabled)
+        {
+            XMStoreFloat4x4(&viewProjections[0], XMMatrixMultiply(view, m_game->GameCamera()->LeftEyeProjection()));
+            XMStoreFloat4x4(&viewProjections[1], XMMatrixMultiply(view, m_game->GameCamera()->RightEyeProjection()));
+        }
+        else
+        {
+            XMStoreFloat4x4(&viewProjections[0], XMMatrixMultiply(view, m_game->GameCamera()->Projection()));
+        }
+        m_renderList->Build(m_game->RenderObjects(), viewProjections, renderingPasses);
+    }
+
     for (int i = 0; i < renderingPasses; i++)
     {
         // Iterate through the number of rendering passes to be completed.
@@ -567,11 +588,7 @@ void GameRenderer::Render()
             d3dContext->PSSetConstantBuffers(3, 1, m_constantBufferChangesEveryPrim.GetAddressOf());
             d3dContext->PSSetSamplers(0, 1, m_samplerLinear.GetAddressOf());
 
-            auto objects = m_game->RenderObjects();
-            for (auto object = objects.begin(); object != objects.end(); object++)
-            {
-                (*object)->Render(d3dContext, m_constantBufferChangesEveryPrim.Get());
-            }
+            m_renderList->Render(d3dContext, m_constantBufferChangesEveryPrim.Get());
         }
         else
         {
@@ -55,6 +55,7 @@
 #include "GameInfoOverlay.h"
 #include "GameHud.h"
 #include "Simple3DGame.h"
+#include "RenderList.h"
 
 ref class Simple3DGame;
 ref class GameHud;
@@ -99,6 +100,7 @@ protected private:
     bool                                                m_levelResourcesLoaded;
     GameInfoOverlay^                                    m_gameInfoOverlay;
     GameHud^                                            m_gameHud;
+    RenderList^                                         m_renderList;
     Simple3DGame^                                       m_game;
     D2D_RECT_F                                          m_gameInfoOverlayRect;
     D2D_SIZE_F                                          m_gameInfoOverlaySize;
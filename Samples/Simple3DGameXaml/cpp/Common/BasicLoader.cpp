@@ -11,6 +11,7 @@
 #include "DDSTextureLoader.h"
 #include "DirectXSample.h"
 #include <memory>
+#include <map>
 
 using namespace Microsoft::WRL;
 using namespace Windows::Storage;
@@ -20,6 +21,12 @@ using namespace Windows::ApplicationModel;
 using namespace std;
 using namespace concurrency;
 
+// The layouts of the DDS textures loaded so far, by file name.  They are shared by
+// all the loaders so that the textures load faster when the device resources are
+// created again, e.g. after the device was lost.
+static std::map<std::wstring, DDSTextureLayout> s_textureLayouts;
+static std::mutex s_textureLayoutsLock;
+
 BasicLoader::BasicLoader(
     _In_ ID3D11Device* d3dDevice,
     _In_opt_ IWICImagingFactory2* wicFactory
@@ -116,25 +123,31 @@ void BasicLoader::CreateTexture(
     {
         ComPtr<ID3D11Resource> resource;
 
-        if (textureView == nullptr)
+        // Start from the layout of the last load of this file, if any.  The layout
+        // is checked against the file headers, so a wrong match only costs a parse.
+        std::wstring key((debugName != nullptr) ? debugName->Data() : L"");
+        DDSTextureLayout layout;
         {
-            CreateDDSTextureFromMemory(
-                m_d3dDevice.Get(),
-                data,
-                dataSize,
-                &resource,
-                nullptr
-                );
+            std::lock_guard<std::mutex> lock(s_textureLayoutsLock);
+            auto cached = s_textureLayouts.find(key);
+            if (cached != s_textureLayouts.end())
+            {
+                layout = cached->second;
+            }
         }
-        else
+
+        CreateDDSTextureFromMemoryWithLayout(
+            m_d3dDevice.Get(),
+            data,
+            dataSize,
+            &layout,
+            &resource,
+            (textureView == nullptr) ? nullptr : &shaderResourceView
+            );
+
         {
-            CreateDDSTextureFromMemory(
-                m_d3dDevice.Get(),
-                data,
-                dataSize,
-                &resource,
-                &shaderResourceView
-                );
+            std::lock_guard<std::mutex> lock(s_textureLayoutsLock);
+            s_textureLayouts[key] = layout;
         }
 
         DX::ThrowIfFailed(
@@ -143,19 +156,24 @@ void BasicLoader::CreateTexture(
     }
     else
     {
-        if (m_wicFactory.Get() == nullptr)
         {
-            // A WIC factory object is required in order to load texture
-            // assets stored in non-DDS formats.  If BasicLoader was not
-            // initialized with one, create one as needed.
-            DX::ThrowIfFailed(
-                CoCreateInstance(
-                    CLSID_WICImagingFactory,
-                    nullptr,
-                    CLSCTX_INPROC_SERVER,
-                    IID_PPV_ARGS(&m_wicFactory)
-                    )
-                );
+            // Several textures may be created at the same time on thread pool threads.
+            std::lock_guard<std::mutex> lock(m_lock);
+
+            if (m_wicFactory.Get() == nullptr)
+            {
+                // A WIC factory object is required in order to load texture
+                // assets stored in non-DDS formats.  If BasicLoader was not
+                // initialized with one, create one as needed.
+                DX::ThrowIfFailed(
+                    CoCreateInstance(
+                        CLSID_WICImagingFactory,
+                        nullptr,
+                        CLSCTX_INPROC_SERVER,
+                        IID_PPV_ARGS(&m_wicFactory)
+                        )
+                    );
+            }
         }
 
         ComPtr<IWICStream> stream;
@@ -311,7 +329,8 @@ void BasicLoader::CreateInputLayout(
 }
 
 void BasicLoader::CreateMesh(
-    _In_ byte* meshData,
+    _In_reads_bytes_(meshDataSize) byte* meshData,
+    _In_ uint32 meshDataSize,
     _Out_ ID3D11Buffer** vertexBuffer,
     _Out_ ID3D11Buffer** indexBuffer,
     _Out_opt_ uint32* vertexCount,
@@ -319,12 +338,27 @@ void BasicLoader::CreateMesh(
     _In_opt_ Platform::String^ debugName
     )
 {
+    if (meshDataSize < sizeof(uint32) * 2)
+    {
+        throw ref new Platform::FailureException();
+    }
+
     // The first 4 bytes of the BasicMesh format define the number of vertices in the mesh.
     uint32 numVertices = *reinterpret_cast<uint32*>(meshData);
 
     // The following 4 bytes define the number of indices in the mesh.
     uint32 numIndices = *reinterpret_cast<uint32*>(meshData + sizeof(uint32));
 
+    // The data is used in place, so make sure the counts don't point past the end of the file.
+    uint64 requiredSize =
+        sizeof(uint32) * 2 +
+        static_cast<uint64>(numVertices) * sizeof(BasicVertex) +
+        static_cast<uint64>(numIndices) * sizeof(uint16);
+    if (numVertices == 0 || numIndices == 0 || requiredSize > meshDataSize)
+    {
+        throw ref new Platform::FailureException();
+    }
+
     // The next segment of the BasicMesh format contains the vertices of the mesh.
     BasicVertex* vertices = reinterpret_cast<BasicVertex*>(meshData + sizeof(uint32) * 2);
 
@@ -378,7 +412,7 @@ void BasicLoader::LoadTexture(
     _Out_opt_ ID3D11ShaderResourceView** textureView
     )
 {
-    Platform::Array<byte>^ textureData = m_basicReaderWriter->ReadData(filename);
+    MappedFileData^ textureData = m_basicReaderWriter->MapData(filename);
 
     CreateTexture(
         GetExtension(filename) == "dds",
@@ -396,7 +430,10 @@ task<void> BasicLoader::LoadTextureAsync(
     _Out_opt_ ID3D11ShaderResourceView** textureView
     )
 {
-    return m_basicReaderWriter->ReadDataAsync(filename).then([=](const Platform::Array<byte>^ textureData)
+    // The continuation runs on the thread pool thread that mapped the file, so
+    // the textures are decoded in parallel rather than one at a time on the
+    // calling thread.
+    return m_basicReaderWriter->MapDataAsync(filename).then([=](MappedFileData^ textureData)
     {
         CreateTexture(
             GetExtension(filename) == "dds",
@@ -839,10 +876,11 @@ void BasicLoader::LoadMesh(
     _Out_opt_ uint32* indexCount
     )
 {
-    Platform::Array<byte>^ meshData = m_basicReaderWriter->ReadData(filename);
+    MappedFileData^ meshData = m_basicReaderWriter->MapData(filename);
 
     CreateMesh(
         meshData->Data,
+        meshData->Length,
         vertexBuffer,
         indexBuffer,
         vertexCount,
@@ -859,10 +897,11 @@ task<void> BasicLoader::LoadMeshAsync(
     _Out_opt_ uint32* indexCount
     )
 {
-    return m_basicReaderWriter->ReadDataAsync(filename).then([=](const Platform::Array<byte>^ meshData)
+    return m_basicReaderWriter->MapDataAsync(filename).then([=](MappedFileData^ meshData)
     {
         CreateMesh(
             meshData->Data,
+            meshData->Length,
             vertexBuffer,
             indexBuffer,
             vertexCount,
@@ -8,9 +8,13 @@
 #pragma once
 
 #include "BasicReaderWriter.h"
+#include <mutex>
 
 // A simple loader class that provides support for loading shaders, textures,
 // and meshes from files on disk. Provides synchronous and asynchronous methods.
+// Textures and meshes are memory mapped and parsed in place.  The asynchronous
+// versions map and parse them on thread pool threads, so several assets load
+// in parallel.
 ref class BasicLoader
 {
 internal:
@@ -138,6 +142,8 @@ private:
     Microsoft::WRL::ComPtr<IWICImagingFactory2> m_wicFactory;
     BasicReaderWriter^ m_basicReaderWriter;
 
+    std::mutex m_lock;
+
     template <class DeviceChildType>
     inline void SetDebugName(
         _In_ DeviceChildType* object,
@@ -166,7 +172,8 @@ private:
         );
 
     void CreateMesh(
-        _In_ byte* meshData,
+        _In_reads_bytes_(meshDataSize) byte* meshData,
+        _In_ uint32 meshDataSize,
         _Out_ ID3D11Buffer** vertexBuffer,
         _Out_ ID3D11Buffer** indexBuffer,
         _Out_opt_ uint32* vertexCount,
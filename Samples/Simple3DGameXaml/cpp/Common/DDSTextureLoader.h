@@ -20,6 +20,37 @@
 
 #pragma once
 
+#include <vector>
+
+// Everything the loader works out from the headers of a DDS file: the resource
+// description in its final format and where each subresource starts in the file.
+// Passing the layout back when the same file is loaded again skips the header
+// parsing, the per-mip pitch computations and, on low feature levels, the failed
+// attempt at creating the texture at full size.
+struct DDSTextureLayout
+{
+    struct Subresource
+    {
+        size_t  offset;         // From the start of the file.
+        uint32  rowPitch;
+        uint32  slicePitch;
+    };
+
+    size_t                      dataSize;       // Size of the whole file.
+    std::vector<byte>           header;         // Copy of the file headers, to detect changed files.
+    D3D_FEATURE_LEVEL           featureLevel;   // The mips kept depend on the feature level.
+    uint32                      resDim;
+    size_t                      width;
+    size_t                      height;
+    size_t                      depth;
+    size_t                      mipCount;
+    size_t                      arraySize;
+    DXGI_FORMAT                 format;
+    bool                        isCubeMap;
+    D2D1_ALPHA_MODE             alphaMode;
+    std::vector<Subresource>    subresources;
+};
+
 void CreateDDSTextureFromMemory(
     _In_ ID3D11Device* d3dDevice,
     _In_reads_bytes_(ddsDataSize) const byte* ddsData,
@@ -44,3 +75,15 @@ void CreateDDSTextureFromMemoryEx(
     _Outptr_opt_ ID3D11ShaderResourceView** textureView,
     _Out_opt_ D2D1_ALPHA_MODE* alphaMode = nullptr
     );
+
+// Same as CreateDDSTextureFromMemory.  If the layout was filled in by an earlier
+// call for the same file and device feature level, it is used as is; otherwise the
+// file is parsed and the layout is filled in.
+void CreateDDSTextureFromMemoryWithLayout(
+    _In_ ID3D11Device* d3dDevice,
+    _In_reads_bytes_(ddsDataSize) const byte* ddsData,
+    _In_ size_t ddsDataSize,
+    _Inout_ DDSTextureLayout* layout,
+    _Outptr_opt_ ID3D11Resource** texture,
+    _Outptr_opt_ ID3D11ShaderResourceView** textureView
+    );
@@ -53,6 +53,7 @@
 #include "DeviceResources.h"
 #include "GameHud.h"
 #include "Simple3DGame.h"
+#include "RenderList.h"
 
 ref class Simple3DGame;
 ref class GameHud;
@@ -88,6 +89,7 @@ protected private:
     bool                                                m_gameResourcesLoaded;
     bool                                                m_levelResourcesLoaded;
     GameHud^                                            m_gameHud;
+    RenderList^                                         m_renderList;
     Simple3DGame^                                       m_game;
 
     Microsoft::WRL::ComPtr<ID3D11ShaderResourceView>    m_sphereTexture;
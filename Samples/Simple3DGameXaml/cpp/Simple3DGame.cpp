@@ -72,9 +72,11 @@ void Simple3DGame::Initialize(
     InitializeGameConfig();
 
     m_ammo = std::vector<Sphere^>(GameConstants::MaxAmmo);
+    m_ammoPhysics = ref new AmmoPhysics(GameConstants::MaxAmmo);
     m_objects = std::vector<GameObject^>();
     m_renderObjects = std::vector<GameObject^>();
     m_level = std::vector<Level^>();
+    m_broadPhase = ref new BroadPhase();
 
     m_savedState = ref new PersistentState();
     m_savedState->Initialize(ApplicationData::Current->LocalSettings->Values, "Game");
@@ -468,15 +470,15 @@ void Simple3DGame::UpdateDynamics()
 
             // Compute initial velocity in world space from camera space.
             XMFLOAT4 initialVelocity(0.0f, 0.0f, 15.0f, 0.0f);
-            m_ammo[m_ammoNext]->Velocity(XMVector4Transform(XMLoadFloat4(&initialVelocity), invView));
+            m_ammoPhysics->Velocity(m_ammoNext, XMVector4Transform(XMLoadFloat4(&initialVelocity), invView));
 
             // Set the initial position of the ammo to be fired. The position is offset from the player
             // to avoid an initial collision with the player object.
             XMFLOAT4 initialPosition(0.0f, -0.15f, m_player->Radius() + GameConstants::AmmoSize, 1.0f);
-            m_ammo[m_ammoNext]->Position(XMVector4Transform(XMLoadFloat4(&initialPosition), invView));
+            m_ammoPhysics->Position(m_ammoNext, XMVector4Transform(XMLoadFloat4(&initialPosition), invView));
 
             // Initially not laying on ground.
-            m_ammo[m_ammoNext]->OnGround(false);
+            m_ammoPhysics->OnGround(m_ammoNext, false);
             m_ammo[m_ammoNext]->Active(true);
 
             // Set position in array of next Ammo to use.
@@ -507,11 +509,16 @@ void Simple3DGame::UpdateDynamics()
             }
         }
     }
+
+    // The objects don't move during the time steps below except for the player, which is
+    // always included in the candidates.
+    m_broadPhase->UpdateObjects(m_objects, m_player);
 #pragma endregion
 
     // If the elapsed time is too long, we slice up the time and handle physics over several
-    // smaller time steps to avoid missing collisions.
-    float timeLeft = timeFrame;
+    // smaller time steps to avoid missing collisions.  After a long stall only MaxStepsPerFrame
+    // steps are computed; catching up on all of them would make the next frame even longer.
+    float timeLeft = min(timeFrame, GameConstants::Physics::FrameLength * GameConstants::Physics::MaxStepsPerFrame);
     float elapsedFrameTime;
     while (timeLeft > 0.0f)
     {
@@ -522,8 +529,10 @@ void Simple3DGame::UpdateDynamics()
         m_player->Position(m_player->VectorPosition() + m_player->VectorVelocity() * elapsedFrameTime);
 
         // Do m_player / object intersections.
-        for (uint32 a = 0; a < m_objects.size(); a++)
+        m_broadPhase->ObjectCandidates(m_player->Position(), m_player->Radius(), &m_candidates);
+        for (uint32 c = 0; c < m_candidates.size(); c++)
         {
+            uint32 a = m_candidates[c];
             if (m_objects[a]->Active() && m_objects[a] != m_player)
             {
                 XMFLOAT3 contact;
@@ -610,64 +619,16 @@ void Simple3DGame::UpdateDynamics()
 #pragma region inter-ammo collision detection
             if (m_ammoCount > 1)
             {
-                for (uint32 one = 0; one < m_ammoCount; one++)
+                // Only the ammo in the neighboring grid cells can be touching.
+                m_broadPhase->UpdateAmmo(m_ammoPhysics, m_ammoCount, GameConstants::AmmoSize);
+                m_ammoPhysics->Collide(m_ammoCount, m_broadPhase->AmmoPairs(), GameConstants::AmmoSize);
+
+                // Start playing the sounds for the impacts between the balls.
+                for (uint32 i = 0; i < m_ammoCount; i++)
                 {
-                    for (uint32 two = (one + 1); two < m_ammoCount; two++)
+                    if (m_ammoPhysics->ContactImpact(i) > 0.0f)
                     {
-                        // Check collision between instances One and Two.
-                        // OneToTwo is the vector between the centers of the two ammo that are being checked.
-                        XMVECTOR oneToTwo;
-                        oneToTwo = m_ammo[two]->VectorPosition() - m_ammo[one]->VectorPosition();
-                        float distanceSquared;
-                        distanceSquared = XMVectorGetX(
-                            XMVector3LengthSq(oneToTwo)
-                            );
-                        if (distanceSquared < (GameConstants::AmmoSize * GameConstants::AmmoSize))
-                        {
-                            // The two ammo are intersecting.
-                            oneToTwo = XMVector3Normalize(oneToTwo);
-
-                            // Check if the two instances are already moving away from each other.
-                            // If so, skip collision.  This can happen when a lot of instances are
-                            // bunched up next to each other.
-                            float impact;
-                            impact = XMVectorGetX(
-                                XMVector3Dot(oneToTwo, m_ammo[one]->VectorVelocity()) -
-                                XMVector3Dot(oneToTwo, m_ammo[two]->VectorVelocity())
-                                );
-                            if (impact > 0.0f)
-                            {
-                                // Compute the normal and tangential components of one's velocity.
-                                XMVECTOR velocityOne = (1 - GameConstants::Physics::BounceLost) * m_ammo[one]->VectorVelocity();
-                                XMVECTOR velocityOneNormal = XMVector3Dot(oneToTwo, velocityOne) * oneToTwo;
-                                XMVECTOR velocityOneTangent = velocityOne - velocityOneNormal;
-                                // Compute the normal and tangential components of two's velocity.
-                                XMVECTOR velocityTwo = (1 - GameConstants::Physics::BounceLost) * m_ammo[two]->VectorVelocity();
-                                XMVECTOR velocityTwoNormal = XMVector3Dot(oneToTwo, velocityTwo) * oneToTwo;
-                                XMVECTOR velocityTwoTangent = velocityTwo - velocityTwoNormal;
-
-                                // Compute the post-collision velocities.
-                                m_ammo[one]->Velocity(velocityOneTangent - velocityOneNormal * (1 - GameConstants::Physics::BounceTransfer) +
-                                    velocityTwoNormal * GameConstants::Physics::BounceTransfer
-                                    );
-                                m_ammo[two]->Velocity(velocityTwoTangent - velocityTwoNormal * (1 - GameConstants::Physics::BounceTransfer) +
-                                    velocityOneNormal * GameConstants::Physics::BounceTransfer
-                                    );
-
-                                // Fix the positions so that the two balls are exactly GameConstants::AmmoSize apart.
-                                float distanceToMove = (GameConstants::AmmoSize - sqrtf(distanceSquared)) * 0.5f;
-                                m_ammo[one]->Position(m_ammo[one]->VectorPosition() - (oneToTwo * distanceToMove));
-                                m_ammo[two]->Position(m_ammo[two]->VectorPosition() + (oneToTwo * distanceToMove));
-
-                                // Flag the two instances so that they are not laying on ground.
-                                m_ammo[one]->OnGround(false);
-                                m_ammo[two]->OnGround(false);
-
-                                // Start playing the sounds for the impact between the two balls.
-                                m_ammo[one]->PlaySound(impact, m_player->Position());
-                                m_ammo[two]->PlaySound(impact, m_player->Position());
-                            }
-                        }
+                        m_ammo[i]->PlaySound(m_ammoPhysics->ContactImpact(i), m_player->Position());
                     }
                 }
             }
@@ -679,10 +640,12 @@ void Simple3DGame::UpdateDynamics()
             {
                 if (m_objects.size() > 0)
                 {
-                    if (!m_ammo[one]->OnGround())
+                    if (!m_ammoPhysics->OnGround(one))
                     {
-                        for (uint32 i = 0; i < m_objects.size(); i++)
+                        m_broadPhase->ObjectCandidates(m_ammoPhysics->Position(one), GameConstants::AmmoRadius, &m_candidates);
+                        for (uint32 c = 0; c < m_candidates.size(); c++)
                         {
+                            uint32 i = m_candidates[c];
                             if (m_objects[i]->Active())
                             {
                                 // The object is currently active in the scene. There may be objects in the list
@@ -690,7 +653,7 @@ void Simple3DGame::UpdateDynamics()
                                 XMFLOAT3 contact;
                                 XMFLOAT3 normal;
 
-                                if (m_objects[i]->IsTouching(m_ammo[one]->Position(), GameConstants::AmmoRadius, &contact, &normal))
+                                if (m_objects[i]->IsTouching(m_ammoPhysics->Position(one), GameConstants::AmmoRadius, &contact, &normal))
                                 {
                                     // Ball is in contact with Object.
                                     XMVECTOR oneToTwo;
@@ -698,26 +661,26 @@ void Simple3DGame::UpdateDynamics()
 
                                     float impact;
                                     impact = XMVectorGetX(
-                                        XMVector3Dot (oneToTwo, m_ammo[one]->VectorVelocity())
+                                        XMVector3Dot (oneToTwo, m_ammoPhysics->VectorVelocity(one))
                                         );
                                     // Make sure that the ball is actually headed towards the object. At grazing angles there
                                     // could appear to be an impact when the ball is actually already hit and moving away.
                                     if (impact > 0.0f)
                                     {
                                         // Compute the normal and tangential components of the ammo's velocity.
-                                        XMVECTOR velocityOne = (1 - GameConstants::Physics::BounceLost) * m_ammo[one]->VectorVelocity();
+                                        XMVECTOR velocityOne = (1 - GameConstants::Physics::BounceLost) * m_ammoPhysics->VectorVelocity(one);
                                         XMVECTOR velocityOneNormal = XMVector3Dot(oneToTwo, velocityOne) * oneToTwo;
                                         XMVECTOR velocityOneTangent = velocityOne - velocityOneNormal;
 
                                         // Compute post-collision velocity of the ammo.
-                                        m_ammo[one]->Velocity(velocityOneTangent - velocityOneNormal * (1 - GameConstants::Physics::BounceTransfer));
+                                        m_ammoPhysics->Velocity(one, velocityOneTangent - velocityOneNormal * (1 - GameConstants::Physics::BounceTransfer));
 
                                         // Fix the position so that the ball is exactly GameConstants::AmmoRadius from target.
                                         float distanceToMove = GameConstants::AmmoSize;
-                                        m_ammo[one]->Position(XMLoadFloat3(&contact) - (oneToTwo * distanceToMove));
+                                        m_ammoPhysics->Position(one, XMLoadFloat3(&contact) - (oneToTwo * distanceToMove));
 
                                         // Flag the Ammo as not laying on ground.
-                                        m_ammo[one]->OnGround(false);
+                                        m_ammoPhysics->OnGround(one, false);
 
                                         // Play the sound associated with the Ammo hitting something.
                                         m_ammo[one]->PlaySound(impact, m_player->Position());
@@ -743,123 +706,26 @@ void Simple3DGame::UpdateDynamics()
 
 #pragma region Apply Gravity and world intersection
             // Apply gravity and check for collision against enclosing volume.
+            m_ammoPhysics->Integrate(m_ammoCount, elapsedFrameTime, m_minBound, m_maxBound, GameConstants::AmmoRadius);
+
+            // Play the sounds of the ammo that hit the floor, ceiling or walls.
             for (uint32 i = 0; i < m_ammoCount; i++)
             {
-                // Update the position and velocity of the ammo instance.
-                m_ammo[i]->Position(m_ammo[i]->VectorPosition() + m_ammo[i]->VectorVelocity() * elapsedFrameTime);
-
-                XMFLOAT3 velocity = m_ammo[i]->Velocity();
-                XMFLOAT3 position = m_ammo[i]->Position();
-
-                velocity.x -= velocity.x * 0.1f * elapsedFrameTime;
-                velocity.z -= velocity.z * 0.1f * elapsedFrameTime;
-                if (!m_ammo[i]->OnGround())
-                {
-                    // Apply gravity if the ammo instance is not already resting on the ground.
-                    velocity.y -= GameConstants::Physics::Gravity * elapsedFrameTime;
-                }
-
-                if (!m_ammo[i]->OnGround())
-                {
-                    float limit = m_minBound.y + GameConstants::AmmoRadius;
-                    if (position.y < limit)
-                    {
-                        // The ammo instance hit the ground.
-                        // Align the ammo instance to the ground, invert the Y component of the velocity and
-                        // play the impact sound. The X and Z velocity components will be reduced
-                        // because of friction.
-                        position.y = limit;
-                        m_ammo[i]->PlaySound(-velocity.y, m_player->Position());
-
-                        velocity.y = -velocity.y * GameConstants::Physics::GroundRestitution;
-                        velocity.x *= GameConstants::Physics::Friction;
-                        velocity.z *= GameConstants::Physics::Friction;
-                    }
-                }
-                else
+                if (m_ammoPhysics->Impact(i) > 0.0f)
                 {
-                    // The ammo instance is resting or rolling on ground.
-                    // X and Z velocity components are reduced because of friction.
-                    velocity.x *= GameConstants::Physics::Friction;
-                    velocity.z *= GameConstants::Physics::Friction;
+                    m_ammo[i]->PlaySound(m_ammoPhysics->Impact(i), m_player->Position());
                 }
-
-                float limit = m_maxBound.y - GameConstants::AmmoRadius;
-                if (position.y > limit)
-                {
-                    // The ammo instance hit the ceiling.
-                    // Align the ammo instance to the ceiling, invert the Y component of the velocity and
-                    // play the impact sound. The X and Z velocity components will be reduced
-                    // because of friction.
-                    position.y = limit;
-                    m_ammo[i]->PlaySound(-velocity.y, m_player->Position());
-
-                    velocity.y = -velocity.y * GameConstants::Physics::GroundRestitution;
-                    velocity.x *= GameConstants::Physics::Friction;
-                    velocity.z *= GameConstants::Physics::Friction;
-                }
-
-                limit = m_minBound.y + GameConstants::AmmoRadius;
-                if ((GameConstants::Physics::Gravity * (position.y - limit) + 0.5f * velocity.y * velocity.y) < GameConstants::Physics::RestThreshold)
-                {
-                    // The Y velocity component is below the resting threshold so flag the instance as
-                    // laying on the ground and set the Y velocity component to zero.
-                    position.y = limit;
-                    velocity.y = 0.0f;
-                    m_ammo[i]->OnGround(true);
-                }
-
-                limit = m_minBound.z + GameConstants::AmmoRadius;
-                if (position.z < limit)
-                {
-                    // The ammo instance hit the a wall in the min Z direction.
-                    // Align the ammo instance to the wall, invert the Z component of the velocity and
-                    // play the impact sound.
-                    position.z = limit;
-                    m_ammo[i]->PlaySound(-velocity.z, m_player->Position());
-                    velocity.z = -velocity.z * GameConstants::Physics::GroundRestitution;
-                }
-
-                limit = m_maxBound.z - GameConstants::AmmoRadius;
-                if (position.z > limit)
-                {
-                    // The ammo instance hit the a wall in the max Z direction.
-                    // Align the ammo instance to the wall, invert the Z component of the velocity and
-                    // play the impact sound.
-                    position.z = limit;
-                    m_ammo[i]->PlaySound(-velocity.z, m_player->Position());
-                    velocity.z = -velocity.z * GameConstants::Physics::GroundRestitution;
-                }
-
-                limit = m_minBound.x + GameConstants::AmmoRadius;
-                if (position.x < limit)
-                {
-                    // The ammo instance hit the a wall in the min X direction.
-                    // Align the ammo instance to the wall, invert the X component of the velocity and
-                    // play the impact sound.
-                    position.x = limit;
-                    m_ammo[i]->PlaySound(-velocity.x, m_player->Position());
-                    velocity.x = -velocity.x * GameConstants::Physics::GroundRestitution;
-                }
-
-                limit = m_maxBound.x - GameConstants::AmmoRadius;
-                if (position.x > limit)
-                {
-                    // The ammo instance hit the a wall in the max X direction.
-                    // Align the ammo instance to the wall, invert the X component of the velocity and
-                    // play the impact sound.
-                    position.x = limit;
-                    m_ammo[i]->PlaySound(-velocity.x, m_player->Position());
-                    velocity.x = -velocity.x * GameConstants::Physics::GroundRestitution;
-                }
-
-                // Save the updated velocity and position for the ammo instance.
-                m_ammo[i]->Velocity(velocity);
-                m_ammo[i]->Position(position);
             }
         }
     }
 #pragma endregion
+
+    // The ammo objects mirror the ammo physics state for rendering and for saving the game state.
+    for (uint32 i = 0; i < m_ammoCount; i++)
+    {
+        m_ammo[i]->Position(m_ammoPhysics->Position(i));
+        m_ammo[i]->Velocity(m_ammoPhysics->Velocity(i));
+    }
 }
 
 //----------------------------------------------------------------------
@@ -997,7 +863,7 @@ void Simple3DGame::SetCurrentLevelToSavedState()
                     );
                 if (m_ammo[i]->Active())
                 {
-                    m_ammo[i]->OnGround(false);
+                    m_ammoPhysics->OnGround(i, false);
                 }
 
                 m_ammo[i]->Position(
@@ -1013,6 +879,9 @@ void Simple3DGame::SetCurrentLevelToSavedState()
                         m_ammo[i]->Velocity()
                         )
                     );
+
+                m_ammoPhysics->Position(i, m_ammo[i]->Position());
+                m_ammoPhysics->Velocity(i, m_ammo[i]->Velocity());
             }
 
             int storedObjectCount = 0;
@@ -22,6 +22,8 @@
 // This class maintains several lists of objects:
 //     m_ammo <Sphere> - is the list of the balls used to throw at targets.  Simple3DGame
 //         cycles through the list in a LRU fashion each time a ball is thrown by the player.
+//         The motion of the balls is computed by m_ammoPhysics <AmmoPhysics>; the spheres
+//         only mirror their positions for rendering.
 //     m_objects <GameObject> - is the list of all objects in the scene that participate in
 //         game physics.  This includes m_player <Sphere> to represent the player in the scene.
 //         The player object (m_player) is not visible in the scene so it is not rendered.
@@ -31,7 +33,9 @@
 
 #include "GameConstants.h"
 #include "GameUIConstants.h"
+#include "AmmoPhysics.h"
 #include "Audio.h"
+#include "BroadPhase.h"
 #include "Camera.h"
 #include "Level.h"
 #include "GameObject.h"
@@ -130,6 +134,7 @@ private:
     Audio^                                      m_audioController;
 
     std::vector<Sphere^>                        m_ammo;
+    AmmoPhysics^                                m_ammoPhysics;
     uint32                                      m_ammoCount;
     uint32                                      m_ammoNext;
 
@@ -154,6 +159,8 @@ private:
     Sphere^                                     m_player;
     std::vector<GameObject^>                    m_objects;           // List of all objects to be included in intersection calculations.
     std::vector<GameObject^>                    m_renderObjects;     // List of all objects to be rendered.
+    BroadPhase^                                 m_broadPhase;        // Finds the objects to include in intersection calculations.
+    std::vector<uint32>                         m_candidates;
 
     DirectX::XMFLOAT3                           m_minBound;
     DirectX::XMFLOAT3                           m_maxBound;
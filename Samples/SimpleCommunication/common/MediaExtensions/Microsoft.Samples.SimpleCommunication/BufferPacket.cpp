@@ -10,6 +10,13 @@
 
 using namespace Microsoft::Samples::SimpleCommunication::Network;
 
+namespace
+{
+    // Most packets consist of a header and one to three payload buffers,
+    // reserve enough space for them so that appending does not reallocate.
+    const size_t c_cDefaultBufferCapacity = 4;
+}
+
 HRESULT Microsoft::Samples::SimpleCommunication::Network::CreateBufferPacketFromMFSample(_In_ IMFSample *pSample, _Outptr_ IBufferPacket **ppBufferPacket)
 {
     return CBufferPacket::FromMFSample(pSample, ppBufferPacket);
@@ -20,9 +27,57 @@ HRESULT Microsoft::Samples::SimpleCommunication::Network::CreateBufferPacket(_Ou
     return CBufferPacket::CreateInstance(ppBufferPacket);
 }
 
+HRESULT Microsoft::Samples::SimpleCommunication::Network::GatherBufferPacket(_In_ IBufferPacket *pBufferPacket, _Outptr_ IMediaBufferWrapper **ppBuffer)
+{
+    if (pBufferPacket == nullptr || ppBuffer == nullptr)
+    {
+        return E_INVALIDARG;
+    }
+
+    ComPtr<IMediaBufferWrapper> spBuffer;
+    HRESULT hr = S_OK;
+
+    if (pBufferPacket->GetBufferCount() == 1)
+    {
+        ComPtr<IBufferEnumerator> spEn;
+        hr = pBufferPacket->GetEnumerator(&spEn);
+        if (SUCCEEDED(hr))
+        {
+            hr = spEn->GetCurrent(&spBuffer);
+        }
+    }
+    else
+    {
+        DWORD cbTotalLength = 0;
+        DWORD cbCopied = 0;
+
+        hr = pBufferPacket->GetTotalLength(&cbTotalLength);
+        if (SUCCEEDED(hr))
+        {
+            hr = CreateMediaBufferWrapper(cbTotalLength, &spBuffer);
+        }
+        if (SUCCEEDED(hr))
+        {
+            hr = pBufferPacket->CopyTo(0, cbTotalLength, spBuffer->GetBuffer(), &cbCopied);
+        }
+        if (SUCCEEDED(hr))
+        {
+            hr = spBuffer->SetCurrentLength(cbCopied);
+        }
+    }
+
+    if (SUCCEEDED(hr))
+    {
+        *ppBuffer = spBuffer.Detach();
+    }
+
+    TRACEHR_RET(hr);
+}
+
 CBufferPacket::CBufferPacket(void)
     : _cRef(1)
 {
+    _buffers.reserve(c_cDefaultBufferCapacity);
 }
 
 
@@ -164,27 +219,19 @@ IFACEMETHODIMP CBufferPacket::InsertBuffer(unsigned int nIndex, IMediaBufferWrap
         return E_INVALIDARG;
     }
 
-    Iterator it = _buffers.begin();
-    Iterator itEnd = _buffers.end();
-
-    for (DWORD nCurrent = 1; nCurrent < nIndex && it != itEnd; ++nCurrent, ++it);
-
-    _buffers.insert(it, pBuffer);
+    _buffers.insert(_buffers.begin() + nIndex, pBuffer);
 
     return S_OK;
 }
 
 IFACEMETHODIMP CBufferPacket::RemoveBuffer(unsigned int nIndex, IMediaBufferWrapper **ppBuffer)
 {
-    if (nIndex > _buffers.size() || ppBuffer == nullptr)
+    if (nIndex >= _buffers.size() || ppBuffer == nullptr)
     {
         return E_INVALIDARG;
     }
 
-    Iterator it = _buffers.begin();
-    Iterator itEnd = _buffers.end();
-
-    for (DWORD nCurrent = 1; nCurrent < nIndex && it != itEnd; ++nCurrent, ++it);
+    Iterator it = _buffers.begin() + nIndex;
 
     *ppBuffer = (*it).Get();
     (*ppBuffer)->AddRef();
@@ -401,11 +448,9 @@ IFACEMETHODIMP CBufferPacket::TrimLeft(DWORD cbSize)
     Iterator itEnd = _buffers.end();
     DWORD cbSkipped = 0;
 
-    for (;cbSkipped < cbSize; it = _buffers.begin())
+    for (;SUCCEEDED(hr) && cbSkipped < cbSize && it != itEnd; ++it)
     {
         DWORD cbLen;
-        DWORD nStart = 0;
-        DWORD cbCopy = 0;
         hr = (*it)->GetCurrentLength(&cbLen);
         if (FAILED(hr))
         {
@@ -413,7 +458,6 @@ IFACEMETHODIMP CBufferPacket::TrimLeft(DWORD cbSize)
         }
         if (cbSkipped + cbLen <= cbSize)
         {
-            _buffers.pop_front();
             cbSkipped += cbLen;
         }
         else
@@ -424,6 +468,9 @@ IFACEMETHODIMP CBufferPacket::TrimLeft(DWORD cbSize)
         }
     }
 
+    // Remove all fully consumed buffers at once instead of shifting the container for each of them
+    _buffers.erase(_buffers.begin(), it);
+
     TRACEHR_RET(hr);
 }
 
@@ -514,7 +561,7 @@ CBufferEnumerator::CBufferEnumerator(CBufferPacket::Container &container, IUnkno
     : _cRef(1)
     , _buffers(container)
     , _spParent(pParent)
-    , _currentIt(container.begin())
+    , _nCurrent(0)
 {
 }
 
@@ -563,7 +610,7 @@ IFACEMETHODIMP_(ULONG) CBufferEnumerator::Release()
 // IBufferEnumerator methods
 IFACEMETHODIMP_ (bool) CBufferEnumerator::IsValid ()
 {
-    return _currentIt != _buffers.end();
+    return _nCurrent < _buffers.size();
 }
 
 IFACEMETHODIMP CBufferEnumerator::GetCurrent (_Out_ IMediaBufferWrapper **ppBuffer)
@@ -578,7 +625,7 @@ IFACEMETHODIMP CBufferEnumerator::GetCurrent (_Out_ IMediaBufferWrapper **ppBuff
         return MF_E_OUT_OF_RANGE;
     }
 
-    *ppBuffer = (*_currentIt).Get();
+    *ppBuffer = _buffers[_nCurrent].Get();
     (*ppBuffer)->AddRef();
 
     return S_OK;
@@ -591,7 +638,7 @@ IFACEMETHODIMP CBufferEnumerator::MoveNext ()
         return MF_E_OUT_OF_RANGE;
     }
 
-    ++_currentIt;
+    ++_nCurrent;
 
     if (!IsValid())
     {
@@ -603,7 +650,7 @@ IFACEMETHODIMP CBufferEnumerator::MoveNext ()
 
 IFACEMETHODIMP CBufferEnumerator::Reset ()
 {
-    _currentIt = _buffers.begin();
+    _nCurrent = 0;
 
     if (!IsValid())
     {
@@ -6,7 +6,7 @@
 //// Copyright (c) Microsoft Corporation. All rights reserved
 
 #pragma once
-#include <list>
+#include <vector>
 #include <StspNetwork.h>
 
 namespace Microsoft { namespace Samples { namespace SimpleCommunication { namespace Network {
@@ -14,8 +14,8 @@ namespace Microsoft { namespace Samples { namespace SimpleCommunication { namesp
     class CBufferPacket : public IBufferPacket
     {
     public:
-        typedef std::list<ComPtr<IMediaBufferWrapper> > Container;
-        typedef std::list<ComPtr<IMediaBufferWrapper> >::iterator Iterator;
+        typedef std::vector<ComPtr<IMediaBufferWrapper> > Container;
+        typedef std::vector<ComPtr<IMediaBufferWrapper> >::iterator Iterator;
 
         static HRESULT FromMFSample(IMFSample *pSample, IBufferPacket **ppBufferPackage);
         static HRESULT CreateInstance(IBufferPacket **ppBufferPackage);
@@ -50,7 +50,7 @@ namespace Microsoft { namespace Samples { namespace SimpleCommunication { namesp
 
     private:
         long                        _cRef;                      // reference count
-        Container                   _buffers;                   // List of packets
+        Container                   _buffers;                   // Buffers of the packet, stored contiguously
     };
 
     class CBufferEnumerator: public IBufferEnumerator
@@ -76,7 +76,7 @@ namespace Microsoft { namespace Samples { namespace SimpleCommunication { namesp
     private:
         long                        _cRef;                      // reference count
         CBufferPacket::Container    &_buffers;                  // List of packets
-        CBufferPacket::Iterator     _currentIt;                 // Current position
+        size_t                      _nCurrent;                  // Index of the current buffer
         ComPtr<IUnknown>            _spParent;                  // Parent object, we hold reference to it to make sure the container is valid all the time.
     };
 
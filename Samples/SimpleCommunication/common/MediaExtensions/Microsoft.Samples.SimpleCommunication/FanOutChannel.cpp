@@ -0,0 +1,229 @@
+//// THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF
+//// ANY KIND, EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO
+//// THE IMPLIED WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A
+//// PARTICULAR PURPOSE.
+////
+//// Copyright (c) Microsoft Corporation. All rights reserved
+
+#include "pch.h"
+#include "FanOutChannel.h"
+#include "StspDefs.h"
+
+using namespace Microsoft::Samples::SimpleCommunication;
+using namespace Microsoft::Samples::SimpleCommunication::Network;
+
+namespace
+{
+    // Client which has this many packets waiting to be sent is too slow to keep up and is disconnected.
+    const DWORD c_cMaxPendingSends = 60;
+    // Sends to a client lagging behind by this many packets are not waited for,
+    // so a single slow client does not slow down the stream for the others.
+    const DWORD c_cLaggingPendingSends = 8;
+
+    enum PacketKind
+    {
+        PacketKind_Other,           // Control packets and samples of other streams, sent to every client
+        PacketKind_VideoKeyFrame,   // Video sample explicitly marked as clean point, clients can join here
+        PacketKind_VideoFrame,      // Any other video sample, dropped for clients which didn't join yet
+    };
+}
+
+CFanOutChannel::CFanOutChannel()
+    : _isClosed(false)
+    , _cEvictedSubscribers(0)
+    , _fHasVideoStream(false)
+    , _dwVideoStreamId(0)
+{
+}
+
+// Clients join at a video key frame. Only samples of the video stream are gated, a video
+// sample is a join point only if it carries the clean point flag and the flag is set.
+int CFanOutChannel::GetPacketKind(IBufferPacket *pPacket)
+{
+    BYTE rgbHeaders[sizeof(StspOperationHeader) + sizeof(StspSampleHeader)];
+    DWORD cbCopied = 0;
+
+    if (!_fHasVideoStream || FAILED(pPacket->CopyTo(0, sizeof(rgbHeaders), rgbHeaders, &cbCopied)) || cbCopied != sizeof(rgbHeaders))
+    {
+        return PacketKind_Other;
+    }
+
+    const StspOperationHeader *pOpHeader = reinterpret_cast<const StspOperationHeader *>(rgbHeaders);
+    const StspSampleHeader *pSampleHeader = reinterpret_cast<const StspSampleHeader *>(rgbHeaders + sizeof(StspOperationHeader));
+
+    if (pOpHeader->eOperation != StspOperation_ServerSample || pSampleHeader->dwStreamId != _dwVideoStreamId)
+    {
+        return PacketKind_Other;
+    }
+
+    if ((pSampleHeader->dwFlagMasks & StspSampleFlag_CleanPoint) != 0 && (pSampleHeader->dwFlags & StspSampleFlag_CleanPoint) != 0)
+    {
+        return PacketKind_VideoKeyFrame;
+    }
+
+    return PacketKind_VideoFrame;
+}
+
+CFanOutChannel::~CFanOutChannel()
+{
+    Disconnect();
+}
+
+Windows::Foundation::IAsyncAction ^CFanOutChannel::SendAsync(_In_ IBufferPacket *pPacket)
+{
+    if (pPacket == nullptr)
+    {
+        throw ref new InvalidArgumentException();
+    }
+    ComPtr<IBufferPacket> spPacket = pPacket;
+
+    return concurrency::create_async([this, spPacket](){
+        AutoLock lock(_critSec);
+        CheckClosed();
+
+        int packetKind = GetPacketKind(spPacket.Get());
+        std::list<CSubscriber^> evicted;
+        std::list<concurrency::task<void>> tasks;
+
+        // Gather the packet once, so the client channels don't each copy it again.
+        ComPtr<IMediaBufferWrapper> spGathered;
+        ComPtr<IBufferPacket> spSendPacket;
+        ThrowIfError(GatherBufferPacket(spPacket.Get(), &spGathered));
+        ThrowIfError(CreateBufferPacket(&spSendPacket));
+        ThrowIfError(spSendPacket->AddBuffer(spGathered.Get()));
+
+        for (auto subscriber : _subscribers)
+        {
+            if (subscriber->fWaitingForKeyFrame)
+            {
+                if (packetKind == PacketKind_VideoFrame)
+                {
+                    // The client can't decode video until it gets a key frame.
+                    continue;
+                }
+                else if (packetKind == PacketKind_VideoKeyFrame)
+                {
+                    subscriber->fWaitingForKeyFrame = false;
+                }
+            }
+
+            if (subscriber->cPendingSends >= c_cMaxPendingSends)
+            {
+                evicted.push_back(subscriber);
+                continue;
+            }
+
+            bool fLagging = subscriber->cPendingSends >= c_cLaggingPendingSends;
+            ++subscriber->cPendingSends;
+
+            auto sendTask = concurrency::create_task(subscriber->Channel->SendAsync(spSendPacket.Get())).then([this, subscriber](concurrency::task<void>& task)
+            {
+                AutoLock lock(_critSec);
+                --subscriber->cPendingSends;
+                try
+                {
+                    task.get();
+                }
+                catch(Exception ^)
+                {
+                    // Client went away, it doesn't affect other clients.
+                    EvictSubscriber(subscriber);
+                }
+            });
+
+            if (!fLagging)
+            {
+                tasks.push_back(sendTask);
+            }
+        }
+
+        for (auto subscriber : evicted)
+        {
+            TRACE(TRACE_LEVEL_NORMAL, L"Disconnecting slow client, %d packets pending\n", subscriber->cPendingSends);
+            EvictSubscriber(subscriber);
+        }
+
+        if (tasks.empty())
+        {
+            return concurrency::create_task([](){});
+        }
+
+        return concurrency::when_all(tasks.begin(), tasks.end());
+    });
+}
+
+Windows::Foundation::IAsyncAction ^CFanOutChannel::ReceiveAsync(_In_ IMediaBufferWrapper *pBuffer)
+{
+    // Clients are read through their own channels.
+    throw ref new Exception(E_NOTIMPL);
+}
+
+void CFanOutChannel::Close()
+{
+    AutoLock lock(_critSec);
+
+    Disconnect();
+
+    _isClosed = true;
+}
+
+void CFanOutChannel::Disconnect()
+{
+    AutoLock lock(_critSec);
+
+    for (auto subscriber : _subscribers)
+    {
+        subscriber->Channel->Close();
+    }
+
+    _subscribers.clear();
+}
+
+void CFanOutChannel::SetVideoStream(DWORD dwStreamId)
+{
+    AutoLock lock(_critSec);
+
+    _fHasVideoStream = true;
+    _dwVideoStreamId = dwStreamId;
+}
+
+void CFanOutChannel::AddSubscriber(INetworkChannel ^channel)
+{
+    if (channel == nullptr)
+    {
+        throw ref new InvalidArgumentException();
+    }
+
+    AutoLock lock(_critSec);
+    CheckClosed();
+
+    _subscribers.push_back(ref new CSubscriber(channel));
+    TRACE(TRACE_LEVEL_NORMAL, L"Client joined, %d clients connected\n", _subscribers.size());
+}
+
+void CFanOutChannel::RemoveSubscriber(INetworkChannel ^channel)
+{
+    AutoLock lock(_critSec);
+
+    _subscribers.remove_if([channel](CSubscriber ^subscriber) { return subscriber->Channel == channel; });
+}
+
+size_t CFanOutChannel::GetSubscriberCount()
+{
+    AutoLock lock(_critSec);
+
+    return _subscribers.size();
+}
+
+void CFanOutChannel::EvictSubscriber(CSubscriber ^subscriber)
+{
+    size_t cSubscribers = _subscribers.size();
+    _subscribers.remove(subscriber);
+
+    if (_subscribers.size() != cSubscribers)
+    {
+        ++_cEvictedSubscribers;
+        subscriber->Channel->Close();
+        TRACE(TRACE_LEVEL_NORMAL, L"Client disconnected, %d clients connected, %d evicted so far\n", _subscribers.size(), _cEvictedSubscribers);
+    }
+}
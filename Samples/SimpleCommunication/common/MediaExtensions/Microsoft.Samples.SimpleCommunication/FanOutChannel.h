@@ -0,0 +1,70 @@
+//// THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF
+//// ANY KIND, EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO
+//// THE IMPLIED WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A
+//// PARTICULAR PURPOSE.
+////
+//// Copyright (c) Microsoft Corporation. All rights reserved
+#pragma once
+#include <list>
+#include "StspNetwork.h"
+
+namespace Microsoft { namespace Samples { namespace SimpleCommunication { namespace Network {
+
+    // Channel sending every packet to all subscribed client connections.
+    // The packet is shared by all the clients, its buffers are never copied.
+    ref class CFanOutChannel sealed: public INetworkChannel
+    {
+    public:
+        virtual ~CFanOutChannel();
+
+    internal:
+        CFanOutChannel();
+
+        // INetworkChannel
+        virtual Windows::Foundation::IAsyncAction ^SendAsync(_In_ IBufferPacket *pPacket) override;
+        virtual Windows::Foundation::IAsyncAction ^ReceiveAsync(_In_ IMediaBufferWrapper *pBuffer) override;
+        virtual void Close() override;
+        virtual void Disconnect() override;
+
+        // Samples of this stream are gated until each new client gets a key frame.
+        void SetVideoStream(DWORD dwStreamId);
+
+        void AddSubscriber(INetworkChannel ^channel);
+        void RemoveSubscriber(INetworkChannel ^channel);
+        size_t GetSubscriberCount();
+
+    private:
+        ref class CSubscriber
+        {
+        internal:
+            CSubscriber(INetworkChannel ^channel)
+                : Channel(channel)
+                , cPendingSends(0)
+                , fWaitingForKeyFrame(true)
+            {
+            }
+
+            INetworkChannel ^Channel;
+            DWORD cPendingSends;        // Packets handed to the channel and not sent yet
+            bool fWaitingForKeyFrame;   // Client joined and didn't receive any video key frame yet
+        };
+
+        void CheckClosed()
+        {
+            if (_isClosed)
+            {
+                throw ref new Exception(MF_E_SHUTDOWN);
+            }
+        }
+
+        int GetPacketKind(IBufferPacket *pPacket);
+        void EvictSubscriber(CSubscriber ^subscriber);
+
+        CritSec _critSec;                // critical section for thread safety
+        bool _isClosed;
+        std::list<CSubscriber^> _subscribers;
+        DWORD _cEvictedSubscribers;
+        bool _fHasVideoStream;
+        DWORD _dwVideoStreamId;
+    };
+}}}}
@@ -10,36 +10,6 @@
 
 using namespace Microsoft::Samples::SimpleCommunication::Network;
 
-namespace
-{
-    ref class CSendOperationStatus
-    {
-    internal:
-        CSendOperationStatus()
-        {
-        }
-
-        void SetException(Exception ^error)
-        {
-            if (_error == nullptr)
-            {
-                _error = error;
-            }
-        }
-
-        void CheckException()
-        {
-            if (_error != nullptr)
-            {
-                throw _error;
-            }
-        }
-
-    private:
-        Exception ^_error;
-    };
-}
-
 CNetworkChannel::CNetworkChannel()
     : _isClosed(false)
 {
@@ -75,42 +45,17 @@ Windows::Foundation::IAsyncAction ^CNetworkChannel::SendAsync(_In_ IBufferPacket
             Throw(E_INVALIDARG);
         }
 
-        std::list<concurrency::task<void>> tasks;
-        CSendOperationStatus ^status = ref new CSendOperationStatus();
+        // The whole packet goes out in a single write instead of one write per buffer.
+        ComPtr<IMediaBufferWrapper> spBuffer;
+        ThrowIfError(GatherBufferPacket(pPacket, &spBuffer));
 
-        for (; spEn->IsValid(); spEn->MoveNext())
-        {
-            ComPtr<IMediaBufferWrapper> spBuffer;
-            ComPtr<IInspectable> spInspectable;
-            DWORD dwLen = 0;
-
-            ThrowIfError(spEn->GetCurrent(&spBuffer));
-
-            ThrowIfError(spBuffer.As(&spInspectable));
-            IBuffer ^buffer = safe_cast<IBuffer^>(reinterpret_cast<Object^>(spInspectable.Get()));
-
-            ThrowIfError(spBuffer->GetCurrentLength(&dwLen));
-
-            tasks.push_back(concurrency::create_task(outputStream->WriteAsync(buffer)).
-                then([this, status](concurrency::task<unsigned int>& task)
-                {
-                    try
-                    {
-                        // We want when_all to finish when all task finish so remember error.
-                        // Otherwise if any of the tasks throws when_all finishes earlier.
-                        task.get();
-                    }
-                    catch(Exception ^exc)
-                    {
-                        status->SetException(exc);
-                    }
-                }));
-        }
+        ComPtr<IInspectable> spInspectable;
+        ThrowIfError(spBuffer.As(&spInspectable));
+        IBuffer ^buffer = safe_cast<IBuffer^>(reinterpret_cast<Object^>(spInspectable.Get()));
 
-        return concurrency::when_all(tasks.begin(), tasks.end())
-            .then([this, status](concurrency::task<void>& task)
+        // The caller only needs to know when the write has completed.
+        return concurrency::create_task(outputStream->WriteAsync(buffer)).then([](unsigned int)
         {
-            status->CheckException();
         });
     });
 }
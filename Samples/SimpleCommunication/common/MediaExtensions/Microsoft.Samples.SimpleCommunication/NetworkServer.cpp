@@ -73,6 +73,24 @@ Windows::Foundation::IAsyncOperation<Windows::Networking::Sockets::StreamSocketI
     });
 }
 
+// Hand over the accepted connection to its own channel, so the server can accept another client.
+INetworkChannel ^CNetworkServer::DetachConnection()
+{
+    AutoLock lock(_critSec);
+    CheckClosed();
+
+    IStreamSocket ^socket = GetSocket();
+    if (socket == nullptr)
+    {
+        Throw(MF_E_NET_NOCONNECTION);
+    }
+
+    SetSocket(nullptr);
+    OnClose();
+
+    return ref new CNetworkConnection(socket);
+}
+
 void CNetworkServer::OnClose()
 {
     if (_acceptOperation != nullptr)
@@ -82,6 +100,15 @@ void CNetworkServer::OnClose()
     }
 }
 
+CNetworkConnection::CNetworkConnection(IStreamSocket ^socket)
+{
+    SetSocket(socket);
+}
+
+CNetworkConnection::~CNetworkConnection()
+{
+}
+
 CAcceptOperation::CAcceptOperation(CNetworkServer ^parent, CritSec &critSec)
     : _parent(parent)
     , _critSec(critSec)
@@ -20,6 +20,7 @@ namespace Microsoft { namespace Samples { namespace SimpleCommunication { namesp
 
         // INetworkServer
         virtual Windows::Foundation::IAsyncOperation<Windows::Networking::Sockets::StreamSocketInformation^>^ AcceptAsync();
+        virtual INetworkChannel ^DetachConnection();
 
     internal:
         CNetworkServer(unsigned short listeningPort);
@@ -32,6 +33,17 @@ namespace Microsoft { namespace Samples { namespace SimpleCommunication { namesp
         CAcceptOperation ^_acceptOperation;
     };
 
+    // Channel of a single client connection detached from the server.
+    ref class CNetworkConnection sealed:
+        public CNetworkChannel
+    {
+    public:
+        virtual ~CNetworkConnection();
+
+    internal:
+        CNetworkConnection(IStreamSocket ^socket);
+    };
+
     ref class CAcceptOperation sealed
     {
     public:
@@ -108,6 +108,38 @@ extern wchar_t const __declspec(selectany) c_szStspScheme[] = L"stsp";
 extern wchar_t const __declspec(selectany) c_szStspSchemeWithColon[] = L"stsp:";
 unsigned short const c_wStspDefaultPort = 10010;
 
+// Scheme handler configuration (property set passed to MediaExtensionManager::RegisterSchemeHandler)
+extern wchar_t const __declspec(selectany) c_szStspJitterBufferEnabled[] = L"JitterBufferEnabled";             // Boolean, off by default
+extern wchar_t const __declspec(selectany) c_szStspJitterBufferMinDelay[] = L"JitterBufferMinDelay";           // UInt32, milliseconds
+extern wchar_t const __declspec(selectany) c_szStspJitterBufferMaxDelay[] = L"JitterBufferMaxDelay";           // UInt32, milliseconds
+extern wchar_t const __declspec(selectany) c_szStspJitterBufferMultiplier[] = L"JitterBufferMultiplier";       // UInt32
+// Jitter buffer statistics of the video stream, written back to the configuration by the source
+extern wchar_t const __declspec(selectany) c_szStspJitterBufferSamplesReceived[] = L"JitterBufferSamplesReceived";
+extern wchar_t const __declspec(selectany) c_szStspJitterBufferSamplesHeld[] = L"JitterBufferSamplesHeld";
+extern wchar_t const __declspec(selectany) c_szStspJitterBufferLateSamples[] = L"JitterBufferLateSamples";
+extern wchar_t const __declspec(selectany) c_szStspJitterBufferJitter[] = L"JitterBufferJitter";                // milliseconds
+extern wchar_t const __declspec(selectany) c_szStspJitterBufferDelay[] = L"JitterBufferDelay";                  // milliseconds
+
+// Jitter buffer of the video stream. Samples are held until their timestamp plus the playout
+// delay, which follows the measured network jitter within the given bounds.
+struct JitterBufferSettings
+{
+    bool fEnabled;
+    LONGLONG hnsMinDelay;
+    LONGLONG hnsMaxDelay;
+    DWORD dwJitterMultiplier;
+};
+
+struct JitterBufferStatistics
+{
+    DWORD cSamplesReceived;
+    DWORD cSamplesHeld;         // Samples which waited for their playout time
+    DWORD cLateSamples;         // Samples which arrived after their playout time
+    LONGLONG hnsJitter;         // Smoothed interarrival jitter
+    LONGLONG hnsDelay;          // Current playout delay
+    LONGLONG hnsMaxDelay;       // Largest network delay seen
+};
+
 void FilterOutputMediaType(IMFMediaType *pSourceMediaType, IMFMediaType *pDestinationMediaType);
 void ValidateInputMediaType(REFGUID guidMajorType, REFGUID guidSubtype, IMFMediaType *pMediaType);
 HRESULT CreateMarker(    
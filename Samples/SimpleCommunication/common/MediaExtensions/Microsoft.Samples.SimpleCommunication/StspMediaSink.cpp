@@ -210,8 +210,9 @@ HRESULT CMediaSink::RuntimeClassInitialize(
     {
         _callback = callback;
         // Create network server
-        INetworkServer ^server = CreateNetworkServer(c_wStspDefaultPort);
-        _networkSender = safe_cast<INetworkChannel^>(server);
+        _networkServer = CreateNetworkServer(c_wStspDefaultPort);
+        // Create channel which sends the samples to all the clients
+        _networkSender = ref new CFanOutChannel();
 
         // Set up media streams
         SetMediaStreamProperties(MediaStreamType::Audio, audioEncodingProperties);
@@ -227,7 +228,12 @@ HRESULT CMediaSink::RuntimeClassInitialize(
         {
             _networkSender->Close();
         }
+        if (_networkServer != nullptr)
+        {
+            safe_cast<INetworkChannel^>(_networkServer)->Close();
+        }
         _networkSender = nullptr;
+        _networkServer = nullptr;
         return exc->HResult;
     }
 
@@ -266,19 +272,25 @@ void CMediaSink::TriggerAcceptConnection(DWORD connectionId)
         if (_waitingConnectionId != 0 && connectionId == _waitingConnectionId)
         {
             _waitingConnectionId = 0;
+            INetworkChannel ^connection = _waitingConnection;
+            _waitingConnection = nullptr;
             ComPtr<CMediaSink> spThis = this;
-            concurrency::create_task([this, spThis]
+            concurrency::create_task([this, spThis, connection]
             {
                 AutoLock lock(_critSec);
                 try
                 {
                     ThrowIfError(CheckShutdown());
 
-                    // Create receive buffer
-                    ThrowIfError(CreateMediaBufferWrapper(c_cbReceiveBuffer, &_spReceiveBuffer));
+                    // Create receive buffer for this client
+                    ComPtr<IMediaBufferWrapper> spReceiveBuffer;
+                    ThrowIfError(CreateMediaBufferWrapper(c_cbReceiveBuffer, &spReceiveBuffer));
 
                     // Start receiving
-                    StartReceiving(_spReceiveBuffer.Get());
+                    StartReceiving(connection, spReceiveBuffer.Get());
+
+                    // Wait for the next client
+                    StartListening();
                 }
                 catch(Exception ^exc)
                 {
@@ -302,16 +314,18 @@ void CMediaSink::TriggerRefuseConnection(DWORD connectionId)
         if (_waitingConnectionId != 0 && connectionId == _waitingConnectionId)
         {
             _waitingConnectionId = 0;
-            ComPtr<CMediaSink> spThis;
-            concurrency::create_task([this, spThis]
+            INetworkChannel ^connection = _waitingConnection;
+            _waitingConnection = nullptr;
+            ComPtr<CMediaSink> spThis = this;
+            concurrency::create_task([this, spThis, connection]
             {
                 AutoLock lock(_critSec);
                 try
                 {
                     ThrowIfError(CheckShutdown());
 
-                    // Connection refused disconnect current client.
-                    _networkSender->Disconnect();
+                    // Connection refused disconnect the client, clients already streaming are not affected.
+                    DropConnection(connection);
 
                     StartListening();
                 }
@@ -680,7 +694,22 @@ IFACEMETHODIMP CMediaSink::Shutdown()
                 _networkSender->Close();
             }
 
+            if (_networkServer != nullptr)
+            {
+                safe_cast<INetworkChannel^>(_networkServer)->Close();
+            }
+
+            // Also closes the clients which haven't started streaming yet, their pending
+            // receive operations hold a reference to the sink.
+            for (auto connection : _connections)
+            {
+                connection->Close();
+            }
+            _connections.clear();
+
             _networkSender = nullptr;
+            _networkServer = nullptr;
+            _waitingConnection = nullptr;
             _spClock.Reset();
 
             _IsShutdown = true;
@@ -763,7 +792,7 @@ void CMediaSink::ReportEndOfStream()
 void CMediaSink::StartListening()
 {
     ComPtr<CMediaSink> spThis = this;
-    concurrency::create_task(safe_cast<INetworkServer^>(_networkSender)->AcceptAsync()).then([spThis, this](concurrency::task<StreamSocketInformation^>& acceptTask)
+    concurrency::create_task(_networkServer->AcceptAsync()).then([spThis, this](concurrency::task<StreamSocketInformation^>& acceptTask)
     {
         IncomingConnectionEventArgs ^args;
         ISinkCallback ^callback;
@@ -779,6 +808,16 @@ void CMediaSink::StartListening()
                 }
                 _remoteUrl = PrepareRemoteUrl(info);
 
+                if (_waitingConnection != nullptr)
+                {
+                    // Previous client was neither accepted nor refused, don't leak its socket.
+                    DropConnection(_waitingConnection);
+                }
+
+                // Move the client to its own channel, so the server can accept the next one.
+                _waitingConnection = _networkServer->DetachConnection();
+                _connections.push_back(_waitingConnection);
+
                 _waitingConnectionId = LODWORD(GetTickCount64());
                 if (_waitingConnectionId == 0) 
                 {
@@ -799,12 +838,12 @@ void CMediaSink::StartListening()
     });    
 }
 
-void CMediaSink::StartReceiving(IMediaBufferWrapper *pReceiveBuffer)
+void CMediaSink::StartReceiving(INetworkChannel ^connection, IMediaBufferWrapper *pReceiveBuffer)
 {
     ComPtr<CMediaSink> spThis = this;
     ComPtr<IMediaBufferWrapper> spReceiveBuffer = pReceiveBuffer;
 
-    concurrency::create_task(_networkSender->ReceiveAsync(pReceiveBuffer)).then([spThis, spReceiveBuffer, this](concurrency::task<void>& task)
+    concurrency::create_task(connection->ReceiveAsync(pReceiveBuffer)).then([spThis, spReceiveBuffer, connection, this](concurrency::task<void>& task)
     {
         AutoLock lock(_critSec);
         try
@@ -841,18 +880,41 @@ void CMediaSink::StartReceiving(IMediaBufferWrapper *pReceiveBuffer)
             {
             case StspOperation_ClientRequestDescription:
                 // Send description to the client
-                SendDescription();
+                SendDescription(connection, spReceiveBuffer.Get());
                 break;
             case StspOperation_ClientRequestStart:
                 {
-                    _IsConnected = true;
-                    if (_spClock)
+                    // Tell the channel which stream carries video, so new clients wait for its next key frame.
+                    StreamContainer::POSITION pos = _streams.FrontPosition();
+                    StreamContainer::POSITION endPos = _streams.EndPosition();
+                    for (;pos != endPos; pos = _streams.Next(pos))
                     {
-                        ThrowIfError(_spClock->GetTime(&_llStartTime));
+                        ComPtr<IMFStreamSink> spStream;
+                        ThrowIfError(_streams.GetItemPos(pos, &spStream));
+
+                        CStreamSink *pStream = static_cast<CStreamSink *>(spStream.Get());
+                        if (pStream->IsVideo())
+                        {
+                            DWORD dwId;
+                            ThrowIfError(pStream->GetIdentifier(&dwId));
+                            _networkSender->SetVideoStream(dwId);
+                        }
                     }
 
-                    // We are now connected we can start streaming.
-                    ForEach(_streams, SetConnectedFunc(true, _llStartTime));
+                    // From now on the client gets the samples, video starting with the next key frame.
+                    _networkSender->AddSubscriber(connection);
+
+                    if (!_IsConnected)
+                    {
+                        _IsConnected = true;
+                        if (_spClock)
+                        {
+                            ThrowIfError(_spClock->GetTime(&_llStartTime));
+                        }
+
+                        // First client is connected we can start streaming.
+                        ForEach(_streams, SetConnectedFunc(true, _llStartTime));
+                    }
                 }
                 break;
             default:
@@ -862,19 +924,32 @@ void CMediaSink::StartReceiving(IMediaBufferWrapper *pReceiveBuffer)
         }
         catch(Exception ^exc)
         {
-            HandleError(exc->HResult);
+            // Problem with one client doesn't stop streaming to the others.
+            DropConnection(connection);
         }
     });
 }
 
 // Send packet
-concurrency::task<void> CMediaSink::SendPacket(Network::IBufferPacket *pPacket)
+concurrency::task<void> CMediaSink::SendPacket(INetworkChannel ^connection, Network::IBufferPacket *pPacket)
 {
-    return concurrency::create_task(_networkSender->SendAsync(pPacket));
+    return concurrency::create_task(connection->SendAsync(pPacket));
+}
+
+// Disconnect a single client
+void CMediaSink::DropConnection(INetworkChannel ^connection)
+{
+    if (_networkSender != nullptr)
+    {
+        _networkSender->RemoveSubscriber(connection);
+    }
+
+    _connections.remove(connection);
+    connection->Close();
 }
 
 // Send media description to the client
-void CMediaSink::SendDescription()
+void CMediaSink::SendDescription(INetworkChannel ^connection, IMediaBufferWrapper *pReceiveBuffer)
 {
     // Size of the description buffer
     const DWORD c_cStreams = _streams.GetCount();
@@ -936,7 +1011,7 @@ void CMediaSink::SendDescription()
 
         ComPtr<CMediaSink> spThis = this;
         // Send the data.
-        SendPacket(spPacket.Get()).then([this, spThis](concurrency::task<void>& task)
+        SendPacket(connection, spPacket.Get()).then([this, spThis, connection](concurrency::task<void>& task)
         {
             try
             {
@@ -945,12 +1020,12 @@ void CMediaSink::SendDescription()
             catch(Exception ^exc)
             {
                 AutoLock lock(_critSec);
-                HandleError(exc->HResult);
+                DropConnection(connection);
             }
         });
 
         // Keep receiving
-        StartReceiving(_spReceiveBuffer.Get());
+        StartReceiving(connection, pReceiveBuffer);
 
         delete[] arrspAttributes;
     }
@@ -6,11 +6,13 @@
 //// Copyright (c) Microsoft Corporation. All rights reserved
 
 #pragma once
+#include <list>
 #include <CritSec.h>
 #include <linklist.h>
 #include <BaseAttributes.h>
 #include <StspDefs.h>
 #include <StspNetwork.h>
+#include <FanOutChannel.h>
 
 namespace Microsoft { namespace Samples { namespace SimpleCommunication {
 interface class ISinkCallback;
@@ -78,10 +80,11 @@ private:
 
 private:
     void StartListening();
-    void StartReceiving(Network::IMediaBufferWrapper *pReceiveBuffer);
-    concurrency::task<void> SendPacket(Network::IBufferPacket *pPacket);
+    void StartReceiving(Network::INetworkChannel ^connection, Network::IMediaBufferWrapper *pReceiveBuffer);
+    concurrency::task<void> SendPacket(Network::INetworkChannel ^connection, Network::IBufferPacket *pPacket);
     String ^PrepareRemoteUrl(StreamSocketInformation ^info);
-    void SendDescription();
+    void SendDescription(Network::INetworkChannel ^connection, Network::IMediaBufferWrapper *pReceiveBuffer);
+    void DropConnection(Network::INetworkChannel ^connection);
 
     ComPtr<Network::IMediaBufferWrapper> FillStreamDescription(CStreamSink *pStream, StspStreamDescription *pStreamDescription);
 
@@ -112,9 +115,11 @@ private:
     LONGLONG                        _llStartTime;
 
     ComPtr<IMFPresentationClock>    _spClock;                   // Presentation clock.
-    Network::INetworkChannel^       _networkSender;  
+    Network::INetworkServer^        _networkServer;
+    Network::CFanOutChannel^        _networkSender;             // Sends samples to all the started clients.
+    Network::INetworkChannel^       _waitingConnection;         // Client waiting to be accepted or refused.
+    std::list<Network::INetworkChannel^> _connections;          // Every client connection not closed yet, closed on shutdown.
     ISinkCallback^                  _callback;
-    ComPtr<Network::IMediaBufferWrapper> _spReceiveBuffer;
     StreamContainer                 _streams;
     long                            _cStreamsEnded;
     String^                         _remoteUrl;
@@ -17,6 +17,25 @@ namespace
 {
     const DWORD c_cbReceiveBufferSize = 2 * 1024;
     const DWORD c_cbMaxPacketSize = 1024 * 1024;
+
+    // Jitter buffer defaults, delays in milliseconds
+    const UINT32 c_dwDefaultMinJitterDelay = 20;
+    const UINT32 c_dwDefaultMaxJitterDelay = 200;
+    const UINT32 c_dwDefaultJitterMultiplier = 4;
+
+    // Returns the configuration value with the given name or the default value when it is not set.
+    IPropertyValue ^GetConfigurationValue(IPropertySet ^configuration, LPCWSTR pszName, Object ^defaultValue)
+    {
+        String ^name = ref new String(pszName);
+        Object ^value = defaultValue;
+
+        if (configuration != nullptr && configuration->HasKey(name))
+        {
+            value = configuration->Lookup(name);
+        }
+
+        return safe_cast<IPropertyValue^>(value);
+    }
 };
 
 CSourceOperation::CSourceOperation(CSourceOperation::Type opType)
@@ -86,13 +105,14 @@ CMediaSource::CMediaSource(void)
 , _flRate(1.0f)
 {
     ZeroMemory(&_CurrentReceivedOperationHeader, sizeof(_CurrentReceivedOperationHeader));
+    ZeroMemory(&_jitterBufferSettings, sizeof(_jitterBufferSettings));
 }
 
 CMediaSource::~CMediaSource(void)
 {
 }
 
-HRESULT CMediaSource::CreateInstance(CMediaSource **ppNetSource)
+HRESULT CMediaSource::CreateInstance(IPropertySet ^configuration, CMediaSource **ppNetSource)
 {
     HRESULT hr = S_OK;
 
@@ -110,7 +130,7 @@ HRESULT CMediaSource::CreateInstance(CMediaSource **ppNetSource)
             Throw(E_OUTOFMEMORY);
         }
 
-        spSource->Initialize();
+        spSource->Initialize(configuration);
 
         *ppNetSource = spSource.Detach();
     }
@@ -348,6 +368,7 @@ IFACEMETHODIMP CMediaSource::Shutdown()
 
         _spEventQueue.Reset();
         _networkSender = nullptr;
+        _configuration = nullptr;
     }
 
     TRACEHR_RET(hr);
@@ -601,7 +622,7 @@ HRESULT CMediaSource::Unlock()
     return S_OK;
 }
 
-void CMediaSource::Initialize()
+void CMediaSource::Initialize(IPropertySet ^configuration)
 {
     try
     {
@@ -612,6 +633,8 @@ void CMediaSource::Initialize()
 
         ThrowIfError(CBaseAttributes<>::Initialize());
 
+        ReadConfiguration(configuration);
+
         // Create network client
         networkClient = CreateNetworkClient();
 
@@ -624,6 +647,35 @@ void CMediaSource::Initialize()
     }
 }
 
+// Reads the jitter buffer settings from the scheme handler configuration.
+void CMediaSource::ReadConfiguration(IPropertySet ^configuration)
+{
+    _configuration = configuration;
+    _jitterBufferSettings.fEnabled = GetConfigurationValue(configuration, c_szStspJitterBufferEnabled, PropertyValue::CreateBoolean(false))->GetBoolean();
+    _jitterBufferSettings.hnsMinDelay = GetConfigurationValue(configuration, c_szStspJitterBufferMinDelay, PropertyValue::CreateUInt32(c_dwDefaultMinJitterDelay))->GetUInt32() * 10000LL;
+    _jitterBufferSettings.hnsMaxDelay = GetConfigurationValue(configuration, c_szStspJitterBufferMaxDelay, PropertyValue::CreateUInt32(c_dwDefaultMaxJitterDelay))->GetUInt32() * 10000LL;
+    _jitterBufferSettings.dwJitterMultiplier = GetConfigurationValue(configuration, c_szStspJitterBufferMultiplier, PropertyValue::CreateUInt32(c_dwDefaultJitterMultiplier))->GetUInt32();
+
+    if (_jitterBufferSettings.hnsMinDelay > _jitterBufferSettings.hnsMaxDelay)
+    {
+        Throw(E_INVALIDARG);
+    }
+}
+
+void CMediaSource::ReportJitterBufferStatistics(const JitterBufferStatistics &statistics)
+{
+    if (_configuration == nullptr)
+    {
+        return;
+    }
+
+    _configuration->Insert(ref new String(c_szStspJitterBufferSamplesReceived), PropertyValue::CreateUInt32(statistics.cSamplesReceived));
+    _configuration->Insert(ref new String(c_szStspJitterBufferSamplesHeld), PropertyValue::CreateUInt32(statistics.cSamplesHeld));
+    _configuration->Insert(ref new String(c_szStspJitterBufferLateSamples), PropertyValue::CreateUInt32(statistics.cLateSamples));
+    _configuration->Insert(ref new String(c_szStspJitterBufferJitter), PropertyValue::CreateUInt32(static_cast<UINT32>(statistics.hnsJitter / 10000)));
+    _configuration->Insert(ref new String(c_szStspJitterBufferDelay), PropertyValue::CreateUInt32(static_cast<UINT32>(statistics.hnsDelay / 10000)));
+}
+
 // Handle errors
 void CMediaSource::HandleError(HRESULT hResult)
 {
@@ -795,7 +847,7 @@ void CMediaSource::Receive()
     }
 
     ComPtr<IMediaBufferWrapper> spBuffer;
-    ThrowIfError(CreateMediaBufferWrapper(c_cbReceiveBufferSize, &spBuffer));
+    ThrowIfError(CreateMediaBufferWrapper(GetReceiveBufferSize(), &spBuffer));
 
     ComPtr<CMediaSource> spThis = this;
     concurrency::create_task(_networkSender->ReceiveAsync(spBuffer.Get())).then([this, spThis](concurrency::task<void>& task)
@@ -821,6 +873,28 @@ void CMediaSource::Receive()
     _spCurrentReceiveBuffer = spBuffer;
 }
 
+// Get size of the next receive buffer. When we are in the middle of a packet its size is already
+// known from the operation header, so the rest of the payload is received into a single buffer
+// instead of being split into many small ones which would have to be walked by every packet operation.
+DWORD CMediaSource::GetReceiveBufferSize()
+{
+    DWORD cbReceiveBufferSize = c_cbReceiveBufferSize;
+
+    if (_spCurrentReceivePacket != nullptr && _CurrentReceivedOperationHeader.eOperation != StspOperation_Unknown)
+    {
+        DWORD cbReceived = 0;
+        ThrowIfError(_spCurrentReceivePacket->GetTotalLength(&cbReceived));
+
+        // Operation header has been validated already so the remaining size is never larger than c_cbMaxPacketSize.
+        if (_CurrentReceivedOperationHeader.cbDataSize > cbReceived + cbReceiveBufferSize)
+        {
+            cbReceiveBufferSize = _CurrentReceivedOperationHeader.cbDataSize - cbReceived;
+        }
+    }
+
+    return cbReceiveBufferSize;
+}
+
 // Parse data stored in current receive buffer
 void CMediaSource::ParseCurrentBuffer()
 {
@@ -993,6 +1067,7 @@ void CMediaSource::ProcessServerDescription(IBufferPacket *pPacket)
             ComPtr<CMediaStream> spStream;
 
             ThrowIfError(CMediaStream::CreateInstance(&pDescription->aStreams[nStream], pPacket, this, &spStream));
+            spStream->SetJitterBufferSettings(_jitterBufferSettings);
 
             ThrowIfError(_streams.InsertBack(spStream.Get()));
         }
@@ -85,7 +85,7 @@ class CMediaSource :
     public Microsoft::Samples::Common::CBaseAttributes<>
 {
 public:
-    static HRESULT CreateInstance(CMediaSource **ppNetSource);
+    static HRESULT CreateInstance(IPropertySet ^configuration, CMediaSource **ppNetSource);
 
     // IUnknown
     IFACEMETHOD (QueryInterface) (REFIID riid, void **ppv);
@@ -130,6 +130,9 @@ public:
     _Releases_lock_(_critSec)
     HRESULT Unlock();
 
+    // Called by the video stream to publish its jitter buffer statistics.
+    void ReportJitterBufferStatistics(const JitterBufferStatistics &statistics);
+
 protected:
     CMediaSource(void);
     ~CMediaSource(void);
@@ -138,7 +141,8 @@ private:
     typedef ComPtrList<IMFMediaStream> StreamContainer;
 
 private:
-    void Initialize();
+    void Initialize(IPropertySet ^configuration);
+    void ReadConfiguration(IPropertySet ^configuration);
     
     void HandleError(HRESULT hResult);
     HRESULT GetStreamById(DWORD dwId, CMediaStream **ppStream);
@@ -148,6 +152,7 @@ private:
     void SendDescribeRequest();
     void SendStartRequest();
     void Receive();
+    DWORD GetReceiveBufferSize();
     void ParseCurrentBuffer();
     void ProcessPacket(StspOperationHeader *pOpHeader, Network::IBufferPacket *pPacket);
     void ProcessServerDescription(Network::IBufferPacket *pPacket);
@@ -196,6 +201,9 @@ private:
     concurrency::task_completion_event<void> _openedEvent;
 
     float                       _flRate;
+
+    IPropertySet^               _configuration;             // Scheme handler configuration, receives the statistics
+    JitterBufferSettings        _jitterBufferSettings;
 };
 
 }}} // namespace Microsoft::Samples::SimpleCommunication
@@ -87,7 +87,15 @@ CMediaStream::CMediaStream(CMediaSource *pSource)
     , _fWaitingForCleanPoint(true)
     , _hnsStartDroppingAt(0)
     , _hnsAmountToDrop(0)
+    , _fTransitBaseSet(false)
+    , _hnsTransitBase(0)
+    , _hnsLastDelay(0)
+    , _jitterBufferTimerCB(this, &CMediaStream::OnJitterBufferTimer)
+    , _jitterBufferTimerKey(0)
+    , _fJitterBufferTimerSet(false)
 {
+    ZeroMemory(&_jitterBufferSettings, sizeof(_jitterBufferSettings));
+    ZeroMemory(&_jitterBufferStats, sizeof(_jitterBufferStats));
 }
 
 CMediaStream::~CMediaStream(void)
@@ -503,6 +511,10 @@ HRESULT CMediaStream::Start()
         if (_eSourceState == SourceState_Stopped ||
             _eSourceState == SourceState_Started)
         {
+            if (_eSourceState == SourceState_Stopped)
+            {
+                ResetJitterBuffer();
+            }
             _eSourceState = SourceState_Started;
             // Inform the client that we've started
             hr = QueueEvent(MEStreamStarted, GUID_NULL, S_OK, nullptr);
@@ -535,6 +547,7 @@ HRESULT CMediaStream::Stop()
             _eSourceState = SourceState_Stopped;
             _tokens.Clear();
             _samples.Clear();
+            CancelJitterBufferTimer();
             // Inform the client that we've stopped.
             hr = QueueEvent(MEStreamStopped, GUID_NULL, S_OK, nullptr);
         }
@@ -581,10 +594,12 @@ HRESULT CMediaStream::Flush()
 
     _tokens.Clear();
     _samples.Clear();
+    CancelJitterBufferTimer();
 
     _fDiscontinuity = false;
     _eDropMode = MF_DROP_MODE_NONE;
     ResetDropTime();
+    ResetJitterBuffer();
 
     return S_OK;
 }
@@ -626,6 +641,7 @@ void CMediaStream::ProcessSample(StspSampleHeader *pSampleHeader, IMFSample *pSa
         // Check if we are in propper state if so deliver the sample otherwise just skip it and don't treat it as an error.
         if (_eSourceState == SourceState_Started)
         {
+            UpdateJitterBuffer(pSampleHeader);
             // Put sample on the list
             ThrowIfError(_samples.InsertBack(pSample));
             // Deliver samples
@@ -770,9 +786,22 @@ void CMediaStream::DeliverSamples()
         ComPtr<IUnknown> spToken;
         BOOL fDrop = FALSE;
         // Get the entry
-        ThrowIfError(_samples.RemoveFront(&spEntry));
+        ThrowIfError(_samples.GetFront(&spEntry));
 
         if (SUCCEEDED(spEntry.As(&spSample)))
+        {
+            LONGLONG hnsWait = GetJitterBufferWait(spSample.Get());
+            if (hnsWait > 0)
+            {
+                // Sample is held in the jitter buffer until its playout time
+                ScheduleJitterBufferTimer(hnsWait);
+                break;
+            }
+        }
+
+        ThrowIfError(_samples.RemoveFront(nullptr));
+
+        if (spSample != nullptr)
         {
             fDrop = ShouldDropSample(spSample.Get());
 
@@ -893,6 +922,136 @@ bool CMediaStream::ShouldDropSample(IMFSample *pSample)
     return fDrop;
 }
 
+// Jitter buffer: estimates network delay and jitter of received video samples from their
+// timestamps and derives the playout delay from them. Sender and receiver clocks are not
+// synchronized, so the delay is measured relative to the fastest sample seen so far.
+// Only used for low-latency playback, where the renderer presents samples as they arrive.
+void CMediaStream::UpdateJitterBuffer(StspSampleHeader *pSampleHeader)
+{
+    if (!_fVideo || !_jitterBufferSettings.fEnabled)
+    {
+        return;
+    }
+
+    LONGLONG hnsTransit = MFGetSystemTime() - pSampleHeader->ullTimestamp;
+    ++_jitterBufferStats.cSamplesReceived;
+
+    if (!_fTransitBaseSet || hnsTransit < _hnsTransitBase)
+    {
+        _hnsTransitBase = hnsTransit;
+        _fTransitBaseSet = true;
+    }
+
+    LONGLONG hnsDelay = hnsTransit - _hnsTransitBase;
+    LONGLONG hnsDelayChange = (hnsDelay > _hnsLastDelay) ? hnsDelay - _hnsLastDelay : _hnsLastDelay - hnsDelay;
+
+    // Running jitter estimate as used by RTP (RFC 3550): J += (|D| - J) / 16
+    _jitterBufferStats.hnsJitter += (hnsDelayChange - _jitterBufferStats.hnsJitter) / 16;
+    _jitterBufferStats.hnsMaxDelay = max(_jitterBufferStats.hnsMaxDelay, hnsDelay);
+    _jitterBufferStats.hnsDelay = min(max(_jitterBufferStats.hnsJitter * _jitterBufferSettings.dwJitterMultiplier, _jitterBufferSettings.hnsMinDelay), _jitterBufferSettings.hnsMaxDelay);
+    _hnsLastDelay = hnsDelay;
+
+    bool fCleanPoint = (pSampleHeader->dwFlags & StspSampleFlag_CleanPoint) != 0;
+
+    if (hnsDelay < _jitterBufferStats.hnsDelay)
+    {
+        ++_jitterBufferStats.cSamplesHeld;
+    }
+    else if (hnsDelay > _jitterBufferStats.hnsDelay)
+    {
+        // Sample missed its playout time. It is still rendered, dropping it would also
+        // mean dropping every following frame up to the next key frame.
+        ++_jitterBufferStats.cLateSamples;
+        TRACE(TRACE_LEVEL_LOW, L"Late sample ts=%I64d delay=%I64d playout delay=%I64d jitter=%I64d\n",
+            pSampleHeader->ullTimestamp, hnsDelay, _jitterBufferStats.hnsDelay, _jitterBufferStats.hnsJitter);
+    }
+
+    if (fCleanPoint)
+    {
+        if (hnsDelay > _jitterBufferSettings.hnsMaxDelay)
+        {
+            // Delay stays high (clock drift or lasting congestion), resynchronize on the key frame
+            // instead of rendering every following frame late.
+            _hnsTransitBase = hnsTransit;
+            _hnsLastDelay = 0;
+        }
+
+        _spSource->ReportJitterBufferStatistics(_jitterBufferStats);
+    }
+}
+
+// Returns how long the sample still has to be held in the jitter buffer.
+LONGLONG CMediaStream::GetJitterBufferWait(IMFSample *pSample)
+{
+    if (!_fVideo || !_jitterBufferSettings.fEnabled || !_fTransitBaseSet || _flRate != 1.0f)
+    {
+        return 0;
+    }
+
+    LONGLONG hnsTimeStamp = 0;
+    ThrowIfError(pSample->GetSampleTime(&hnsTimeStamp));
+
+    LONGLONG hnsPlayoutTime = hnsTimeStamp + _hnsTransitBase + _jitterBufferStats.hnsDelay;
+    LONGLONG hnsNow = MFGetSystemTime();
+
+    return (hnsPlayoutTime > hnsNow) ? hnsPlayoutTime - hnsNow : 0;
+}
+
+void CMediaStream::ScheduleJitterBufferTimer(LONGLONG hnsWait)
+{
+    if (!_fJitterBufferTimerSet)
+    {
+        // Negative timeout is relative, in milliseconds. Round up so the sample is due when the timer fires.
+        ThrowIfError(MFScheduleWorkItem(&_jitterBufferTimerCB, nullptr, -((hnsWait + 9999) / 10000), &_jitterBufferTimerKey));
+        _fJitterBufferTimerSet = true;
+    }
+}
+
+void CMediaStream::CancelJitterBufferTimer()
+{
+    if (_fJitterBufferTimerSet)
+    {
+        MFCancelWorkItem(_jitterBufferTimerKey);
+        _fJitterBufferTimerSet = false;
+    }
+}
+
+HRESULT CMediaStream::OnJitterBufferTimer(IMFAsyncResult *pAsyncResult)
+{
+    CSourceLock lock(_spSource.Get());
+
+    _fJitterBufferTimerSet = false;
+
+    try
+    {
+        if (_eSourceState == SourceState_Started)
+        {
+            DeliverSamples();
+        }
+    }
+    catch(Exception ^exc)
+    {
+        HandleError(exc->HResult);
+    }
+
+    return S_OK;
+}
+
+void CMediaStream::ResetJitterBuffer()
+{
+    if (_jitterBufferStats.cSamplesReceived > 0)
+    {
+        TRACE(TRACE_LEVEL_NORMAL, L"Jitter buffer: received=%d held=%d late=%d jitter=%I64d max delay=%I64d\n",
+            _jitterBufferStats.cSamplesReceived, _jitterBufferStats.cSamplesHeld, _jitterBufferStats.cLateSamples,
+            _jitterBufferStats.hnsJitter, _jitterBufferStats.hnsMaxDelay);
+    }
+
+    _fTransitBaseSet = false;
+    _hnsTransitBase = 0;
+    _hnsLastDelay = 0;
+    ZeroMemory(&_jitterBufferStats, sizeof(_jitterBufferStats));
+}
+
 void CMediaStream::CleanSampleQueue()
 {
     auto pos = _samples.FrontPosition();
@@ -9,6 +9,7 @@
 #include <CritSec.h>
 #include <linklist.h>
 #include <StspDefs.h>
+#include <AsyncCB.h>
 
 namespace Microsoft { namespace Samples { namespace SimpleCommunication {
     class CMediaSource;
@@ -65,6 +66,8 @@ namespace Microsoft { namespace Samples { namespace SimpleCommunication {
         void ProcessSample(StspSampleHeader *pSampleHeader, IMFSample *pSample);
         void ProcessFormatChange(IMFMediaType *pMediaType);
         HRESULT SetActive(bool fActive);
+        void SetJitterBufferSettings(const JitterBufferSettings &settings) {_jitterBufferSettings = settings;}
+        void GetJitterBufferStatistics(JitterBufferStatistics *pStatistics) const {*pStatistics = _jitterBufferStats;}
         bool IsActive() const {return _fActive;}
         SourceState GetState() const {return _eSourceState;}
 
@@ -96,6 +99,12 @@ namespace Microsoft { namespace Samples { namespace SimpleCommunication {
         }
 
         bool ShouldDropSample(IMFSample *pSample);
+        void UpdateJitterBuffer(StspSampleHeader *pSampleHeader);
+        LONGLONG GetJitterBufferWait(IMFSample *pSample);
+        void ScheduleJitterBufferTimer(LONGLONG hnsWait);
+        void CancelJitterBufferTimer();
+        HRESULT OnJitterBufferTimer(IMFAsyncResult *pAsyncResult);
+        void ResetJitterBuffer();
         void CleanSampleQueue();
         void ResetDropTime();
 
@@ -121,6 +130,16 @@ namespace Microsoft { namespace Samples { namespace SimpleCommunication {
         bool                        _fWaitingForCleanPoint;
         LONGLONG                    _hnsStartDroppingAt;
         LONGLONG                    _hnsAmountToDrop;
+
+        // Jitter buffer state
+        JitterBufferSettings        _jitterBufferSettings;
+        JitterBufferStatistics      _jitterBufferStats;
+        bool                        _fTransitBaseSet;
+        LONGLONG                    _hnsTransitBase;            // Smallest observed difference between arrival time and sample time
+        LONGLONG                    _hnsLastDelay;              // Network delay of the previous sample relative to the base
+        AsyncCallback<CMediaStream> _jitterBufferTimerCB;       // Wakes up delivery when the first held sample is due
+        MFWORKITEM_KEY              _jitterBufferTimerKey;
+        bool                        _fJitterBufferTimerSet;
     };
 
 }}} // namespace Microsoft::Samples::SimpleCommunication
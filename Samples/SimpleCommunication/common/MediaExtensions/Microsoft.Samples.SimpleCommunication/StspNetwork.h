@@ -61,6 +61,7 @@ namespace Microsoft { namespace Samples { namespace SimpleCommunication { namesp
     interface class INetworkServer
     {
         Windows::Foundation::IAsyncOperation<Windows::Networking::Sockets::StreamSocketInformation^>^ AcceptAsync();
+        INetworkChannel ^DetachConnection();
     };
 
     interface class INetworkClient
@@ -72,6 +73,8 @@ namespace Microsoft { namespace Samples { namespace SimpleCommunication { namesp
     HRESULT CreateMediaBufferWrapper(_In_ IMFMediaBuffer *pMediaBuffer, _Outptr_ IMediaBufferWrapper **ppMediaBufferWrapper);
     HRESULT CreateBufferPacketFromMFSample(_In_ IMFSample *pSample, _Outptr_ IBufferPacket **ppBufferPacket);
     HRESULT CreateBufferPacket(_Outptr_ IBufferPacket **ppBufferPacket);
+    // Returns the data of the packet in one buffer, copying it when the packet has several.
+    HRESULT GatherBufferPacket(_In_ IBufferPacket *pBufferPacket, _Outptr_ IMediaBufferWrapper **ppBuffer);
 
     INetworkServer ^CreateNetworkServer(unsigned short listeningPort);
     INetworkClient ^CreateNetworkClient();
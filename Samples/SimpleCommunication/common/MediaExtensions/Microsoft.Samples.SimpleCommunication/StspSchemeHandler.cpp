@@ -27,7 +27,18 @@ CSchemeHandler::~CSchemeHandler(void)
 // IMediaExtension methods
 IFACEMETHODIMP CSchemeHandler::SetProperties (ABI::Windows::Foundation::Collections::IPropertySet *pConfiguration)
 {
-    return S_OK;
+    HRESULT hr = S_OK;
+
+    try
+    {
+        _configuration = (pConfiguration != nullptr) ? safe_cast<IPropertySet^>(reinterpret_cast<Object^>(pConfiguration)) : nullptr;
+    }
+    catch(Exception ^exc)
+    {
+        hr = exc->HResult;
+    }
+
+    TRACEHR_RET(hr);
 }
 
 // IMFSchemeHandler methods
@@ -60,7 +71,7 @@ IFACEMETHODIMP CSchemeHandler::BeginCreateObject(
         }
 
         ComPtr<IMFAsyncResult> spResult;
-        ThrowIfError(CMediaSource::CreateInstance(&spSource));
+        ThrowIfError(CMediaSource::CreateInstance(_configuration, &spSource));
 
         ComPtr<IUnknown> spSourceUnk;
         ThrowIfError(spSource.As(&spSourceUnk));
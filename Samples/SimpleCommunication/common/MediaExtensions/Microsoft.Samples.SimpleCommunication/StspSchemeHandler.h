@@ -40,6 +40,9 @@ public:
         
     IFACEMETHOD (CancelObjectCreation) ( 
             _In_ IUnknown *pIUnknownCancelCookie);
+
+private:
+    IPropertySet^ _configuration;   // Configuration passed on to every source
 };
 
 }}} // namespace Microsoft::Samples::SimpleCommunication
@@ -12,6 +12,27 @@
 using namespace Microsoft::Samples::SimpleCommunication;
 using namespace Microsoft::Samples::SimpleCommunication::Network;
 
+namespace
+{
+    // Maximum number of queued samples coalesced into a single network send.
+    const DWORD c_cMaxSamplesPerSend = 8;
+
+    // Appends all buffers of the source packet to the destination packet.
+    // Buffers are shared by reference, the payload is not copied.
+    void AppendPacket(IBufferPacket *pDestination, IBufferPacket *pSource)
+    {
+        ComPtr<IBufferEnumerator> spEn;
+        ThrowIfError(pSource->GetEnumerator(&spEn));
+
+        for (; spEn->IsValid(); spEn->MoveNext())
+        {
+            ComPtr<IMediaBufferWrapper> spBuffer;
+            ThrowIfError(spEn->GetCurrent(&spBuffer));
+            ThrowIfError(pDestination->AddBuffer(spBuffer.Get()));
+        }
+    }
+}
+
 #define SET_SAMPLE_FLAG(dest, destMask, pSample, flagName) \
     { \
         UINT32 unValue; \
@@ -919,6 +940,14 @@ bool CStreamSink::ProcessSamplesFromQueue(bool fFlush)
                 // Prepare sample for sending
                 spPacket = PrepareSample(spSample.Get(), false);
                 fProcessingSample = true;
+
+                if (spPacket)
+                {
+                    // Send samples which are already waiting in the queue together with this one.
+                    // Each of them still has its own OpProcessSample work item, which finds the
+                    // queue empty and requests the sample that replaces it.
+                    AppendQueuedSamples(spPacket.Get());
+                }
             }
         }
         else
@@ -969,7 +998,8 @@ bool CStreamSink::ProcessSamplesFromQueue(bool fFlush)
                     ThrowIfError(CheckShutdown());
                     if (_state == State_Started && fProcessingSample)
                     {
-                        // If we are still in started state request another sample
+                        // If we are still in started state request another sample. Samples sent
+                        // along with this one are requested again by their own work items.
                         ThrowIfError(QueueEvent(MEStreamSinkRequestSample, GUID_NULL, S_OK, nullptr));
                     }
                 }
@@ -1004,6 +1034,41 @@ bool CStreamSink::ProcessSamplesFromQueue(bool fFlush)
     return fNeedMoreSamples;
 }
 
+// Coalesce samples waiting at the front of the queue into the packet which is about to be sent,
+// so a backlog of samples goes out in a single network write instead of one write per sample.
+void CStreamSink::AppendQueuedSamples(IBufferPacket *pPacket)
+{
+    assert(pPacket != nullptr);
+    DWORD cSamples = 0;
+
+    while (cSamples + 1 < c_cMaxSamplesPerSend)
+    {
+        ComPtr<IUnknown> spunkNext;
+        ComPtr<IMFSample> spNextSample;
+
+        // Markers and format changes have to be processed in order, so stop at the first one.
+        if (FAILED(_SampleQueue.GetFront(&spunkNext)) || FAILED(spunkNext.As(&spNextSample)))
+        {
+            break;
+        }
+
+        // Key frame starts a new packet, so clients joining the stream can start decoding with it.
+        if (MFGetAttributeUINT32(spNextSample.Get(), MFSampleExtension_CleanPoint, FALSE) && _fIsVideo)
+        {
+            break;
+        }
+
+        ThrowIfError(_SampleQueue.RemoveFront(spunkNext.ReleaseAndGetAddressOf()));
+        ++cSamples;
+
+        ComPtr<IBufferPacket> spNextPacket = PrepareSample(spNextSample.Get(), false);
+        if (spNextPacket)
+        {
+            AppendPacket(pPacket, spNextPacket.Get());
+        }
+    }
+}
+
 // Processing format change
 void CStreamSink::ProcessFormatChange(IMFMediaType *pMediaType)
 {
@@ -142,6 +142,7 @@ private:
     bool        DropSamplesFromQueue();
     bool        SendSampleFromQueue();
     bool        ProcessSamplesFromQueue(bool fFlush);
+    void        AppendQueuedSamples(Network::IBufferPacket *pPacket);
     void        ProcessFormatChange(IMFMediaType *pMediaType);
 
     ComPtr<Network::IBufferPacket> PrepareSample(IMFSample *pSample, bool fForce);
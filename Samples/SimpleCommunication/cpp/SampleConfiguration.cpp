@@ -22,3 +22,4 @@ Platform::Array<Scenario>^ MainPage::scenariosInner = ref new Platform::Array<Sc
 };
 
 Windows::Media::MediaExtensionManager^ MainPage::mediaExtensionManager;
+Windows::Foundation::Collections::IPropertySet^ MainPage::schemeHandlerConfigurationInner;
@@ -35,18 +35,29 @@ namespace SDKTemplate
             }
         }
 
+        // Configuration of the stsp: scheme handler, read by every media source it opens.
+        static property Windows::Foundation::Collections::IPropertySet^ schemeHandlerConfiguration
+        {
+            Windows::Foundation::Collections::IPropertySet^ get()
+            {
+                return schemeHandlerConfigurationInner;
+            }
+        }
+
         static void EnsureExtensionRegistration()
         {
             if (mediaExtensionManager == nullptr)
             {
                 mediaExtensionManager = ref new Windows::Media::MediaExtensionManager();
-                mediaExtensionManager->RegisterSchemeHandler("Microsoft.Samples.SimpleCommunication.StspSchemeHandler", "stsp:");
+                schemeHandlerConfigurationInner = ref new Windows::Foundation::Collections::PropertySet();
+                mediaExtensionManager->RegisterSchemeHandler("Microsoft.Samples.SimpleCommunication.StspSchemeHandler", "stsp:", schemeHandlerConfigurationInner);
             }
         }
 
     private:
         static Platform::Array<Scenario>^ scenariosInner;
         static Windows::Media::MediaExtensionManager^ mediaExtensionManager;
+        static Windows::Foundation::Collections::IPropertySet^ schemeHandlerConfigurationInner;
     };
 
     public value struct Scenario
@@ -526,6 +526,8 @@ IAsyncAction^ Scenario1_LowLatency::previewing_recordingStarted()
     {
         return create_task(_dispatcher->RunAsync(CoreDispatcherPriority::Normal, ref new DispatchedHandler([this]()
         {
+            //// The jitter buffer of the source smooths out network jitter for real-time playback
+            MainPage::schemeHandlerConfiguration->Insert("JitterBufferEnabled", _latencyMode == LatencyModes::lowLatency);
             _localHostVideo[_latencyMode]->Source = ref new Uri("stsp://localhost");
             _previousState = _currentState;
             _currentState = ScenarioOneStates::streaming;
@@ -622,6 +624,7 @@ IAsyncAction^ Scenario1_LowLatency::streaming_recordingStarted()
     {
         return create_task(_dispatcher->RunAsync(CoreDispatcherPriority::Normal, ref new DispatchedHandler([this]()
         {
+            MainPage::schemeHandlerConfiguration->Insert("JitterBufferEnabled", _latencyMode == LatencyModes::lowLatency);
             _localHostVideo[_latencyMode]->Source = ref new Uri("stsp://localhost");
             _localHostVideo[_latencyMode]->Play();
         })));
@@ -0,0 +1,147 @@
+//*********************************************************
+//
+// Copyright (c) Microsoft. All rights reserved.
+// THIS CODE IS PROVIDED *AS IS* WITHOUT WARRANTY OF
+// ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING ANY
+// IMPLIED WARRANTIES OF FITNESS FOR A PARTICULAR
+// PURPOSE, MERCHANTABILITY, OR NON-INFRINGEMENT.
+//
+//*********************************************************
+
+//
+// AudioRingBuffer.h
+//
+
+#pragma once
+
+#include <atomic>
+
+namespace SDKSample
+{
+    namespace WASAPIAudio
+    {
+        // Byte ring buffer between a single writer thread and a single reader thread, such as the
+        // capture callback and the WAV file writer.  Neither side takes a lock or allocates memory,
+        // so the audio thread on either end never waits on the other one.
+        class AudioRingBuffer
+        {
+        public:
+            AudioRingBuffer() :
+                m_Buffer( nullptr ),
+                m_cbCapacity( 0 ),
+                m_WritePosition( 0 ),
+                m_ReadPosition( 0 )
+            {
+            }
+
+            ~AudioRingBuffer()
+            {
+                SAFE_ARRAYDELETE( m_Buffer );
+            }
+
+            //
+            //  Initialize()
+            //
+            //  Allocates the buffer.  The capacity is rounded up to a power of two.
+            //
+            HRESULT Initialize( UINT32 cbCapacity )
+            {
+                UINT32 cbRounded = 1;
+                while (cbRounded < cbCapacity)
+                {
+                    cbRounded <<= 1;
+                }
+
+                SAFE_ARRAYDELETE( m_Buffer );
+                m_Buffer = new (std::nothrow) BYTE[ cbRounded ];
+                if (nullptr == m_Buffer)
+                {
+                    return E_OUTOFMEMORY;
+                }
+
+                m_cbCapacity = cbRounded;
+                m_WritePosition = 0;
+                m_ReadPosition = 0;
+
+                return S_OK;
+            }
+
+            //
+            //  GetReadableBytes()
+            //
+            UINT32 GetReadableBytes() const
+            {
+                // The positions only grow (modulo 2^32), so their difference is the fill level
+                return m_WritePosition.load( std::memory_order_acquire ) - m_ReadPosition.load( std::memory_order_relaxed );
+            }
+
+            //
+            //  GetWritableBytes()
+            //
+            UINT32 GetWritableBytes() const
+            {
+                return m_cbCapacity - (m_WritePosition.load( std::memory_order_relaxed ) - m_ReadPosition.load( std::memory_order_acquire ));
+            }
+
+            //
+            //  Write()
+            //
+            //  Called by the writer only.  Returns FALSE and writes nothing if there is not enough room.
+            //
+            BOOL Write( const BYTE *pData, UINT32 cbData )
+            {
+                UINT32 WritePosition = m_WritePosition.load( std::memory_order_relaxed );
+                if (cbData > GetWritableBytes())
+                {
+                    return FALSE;
+                }
+
+                UINT32 Offset = WritePosition & (m_cbCapacity - 1);
+                UINT32 cbFirst = min( cbData, m_cbCapacity - Offset );
+
+                memcpy( m_Buffer + Offset, pData, cbFirst );
+                memcpy( m_Buffer, pData + cbFirst, cbData - cbFirst );
+                m_WritePosition.store( WritePosition + cbData, std::memory_order_release );
+
+                return TRUE;
+            }
+
+            //
+            //  Read()
+            //
+            //  Called by the reader only.  cbData must not be larger than GetReadableBytes().
+            //
+            void Read( BYTE *pData, UINT32 cbData )
+            {
+                UINT32 ReadPosition = m_ReadPosition.load( std::memory_order_relaxed );
+
+                UINT32 Offset = ReadPosition & (m_cbCapacity - 1);
+                UINT32 cbFirst = min( cbData, m_cbCapacity - Offset );
+
+                memcpy( pData, m_Buffer + Offset, cbFirst );
+                memcpy( pData + cbFirst, m_Buffer, cbData - cbFirst );
+                m_ReadPosition.store( ReadPosition + cbData, std::memory_order_release );
+            }
+
+            //
+            //  Skip()
+            //
+            //  Called by the reader only.  Discards cbData bytes, which must not be more than GetReadableBytes().
+            //
+            void Skip( UINT32 cbData )
+            {
+                m_ReadPosition.store( m_ReadPosition.load( std::memory_order_relaxed ) + cbData, std::memory_order_release );
+            }
+
+        private:
+            BYTE                   *m_Buffer;
+            UINT32                  m_cbCapacity;
+
+            // The padding keeps the positions on separate cache lines so the two threads don't contend
+            BYTE                    m_Padding1[64];
+            std::atomic<UINT32>     m_WritePosition;
+            BYTE                    m_Padding2[64];
+            std::atomic<UINT32>     m_ReadPosition;
+        };
+    }
+}
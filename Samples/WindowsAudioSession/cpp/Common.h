@@ -117,41 +117,22 @@ class CAsyncState :
     public RuntimeClass<RuntimeClassFlags<ClassicCom>, IUnknown>
 {  
 public:  
-    CAsyncState( Platform::Array<int,1>^ data, UINT32 size ) :
+    CAsyncState( Platform::Array<int,1>^ data, UINT32 size, float rms ) :
         m_Data(data), 
-        m_Size(size)
+        m_Size(size),
+        m_Rms(rms)
     {  
     };  
 
 public:
     Platform::Array<int,1>^  m_Data;
     UINT32                   m_Size;
+    float                    m_Rms;
 
 private:
     virtual ~CAsyncState() {};
 }; 
 
-struct RenderBuffer
-{
-    UINT32          BufferSize;
-    UINT32          BytesFilled;
-    BYTE           *Buffer;
-    RenderBuffer   *Next;
-
-    RenderBuffer() :
-        BufferSize(0),
-        BytesFilled(0),
-        Buffer( nullptr ),
-        Next( nullptr )
-    {
-    }
-
-    ~RenderBuffer()
-    {
-        SAFE_ARRAYDELETE( Buffer );
-    }
-};
-
 enum RenderSampleType
 {
     SampleTypeUnknown,
@@ -23,12 +23,18 @@ using namespace SDKSample::WASAPIAudio;
 MFSampleGenerator::MFSampleGenerator() :
     m_Ref( 1 ),
     m_IsInitialized( false ),
-    m_BytesPerPeriod( 0 ),
     m_ReaderState( ReaderStateStopped ),
     m_MFSourceReader( nullptr ),
     m_AudioMT( nullptr ),
-    m_SampleQueue( nullptr ),
-    m_SampleQueueTail( &m_SampleQueue )
+    m_cbHighWatermark( 0 ),
+    m_cbLowWatermark( 0 ),
+    m_ReadPaused( 0 ),
+    m_PendingBuffer( nullptr ),
+    m_cbPendingBuffer( 0 ),
+    m_cbPendingQueued( 0 ),
+    m_UnderrunCount( 0 ),
+    m_PoolMissCount( 0 ),
+    m_cbMinQueued( UINT_MAX )
 {
 }
 
@@ -45,12 +51,11 @@ MFSampleGenerator::~MFSampleGenerator()
 //
 void MFSampleGenerator::Flush()
 {
-    while( m_SampleQueue != nullptr )
-    {
-        RenderBuffer *SampleBuffer = m_SampleQueue;
-        m_SampleQueue = SampleBuffer->Next;
-        SAFE_DELETE( SampleBuffer );
-    }
+    m_SampleQueue.Skip( m_SampleQueue.GetReadableBytes() );
+
+    SAFE_RELEASE( m_PendingBuffer );
+    m_cbPendingBuffer = 0;
+    m_cbPendingQueued = 0;
 }
 
 //
@@ -114,7 +119,7 @@ void MFSampleGenerator::StopSource()
 //
 //  Configure the Source Reader
 //
-HRESULT MFSampleGenerator::Initialize( IRandomAccessStream^ stream, UINT32 FramesPerPeriod, WAVEFORMATEX *wfx )
+HRESULT MFSampleGenerator::Initialize( IRandomAccessStream^ stream, WAVEFORMATEX *wfx )
 {
     HRESULT hr = S_OK;
 
@@ -172,7 +177,16 @@ HRESULT MFSampleGenerator::Initialize( IRandomAccessStream^ stream, UINT32 Frame
         goto exit;
     }
 
-    m_BytesPerPeriod = FramesPerPeriod * m_MixFormat->nBlockAlign;
+    // Allocate the sample queue up front, so decoding doesn't allocate memory for the queue and
+    // the memory use doesn't depend on the length of the file
+    hr = m_SampleQueue.Initialize( m_MixFormat->nAvgBytesPerSec * QUEUE_DURATION_SEC );
+    if ( FAILED( hr ) )
+    {
+        goto exit;
+    }
+
+    m_cbHighWatermark = m_MixFormat->nAvgBytesPerSec * HIGH_WATERMARK_SEC;
+    m_cbLowWatermark = m_MixFormat->nAvgBytesPerSec * LOW_WATERMARK_SEC;
     m_IsInitialized = true;
 
 exit:
@@ -373,14 +387,41 @@ HRESULT MFSampleGenerator::OnReadSample(_In_ HRESULT hrStatus, _In_ DWORD dwStre
         return S_OK;
     }
 
-    // Add the data from the Media Sample to our buffer queue
-    hr = AddSamplesToQueue( pSample );
+    // Add the data from the Media Sample to our buffer queue.  Reading is paused while part of
+    // a sample is pending, so there is never more than one.
+    if (pSample != nullptr)
+    {
+        // Since we are storing the raw byte data, convert this to a single buffer
+        hr = pSample->ConvertToContiguousBuffer( &m_PendingBuffer );
+        if (SUCCEEDED( hr ))
+        {
+            hr = m_PendingBuffer->GetCurrentLength( &m_cbPendingBuffer );
+        }
+
+        if (SUCCEEDED( hr ))
+        {
+            m_cbPendingQueued = 0;
+            hr = QueuePendingBuffer();
+        }
+        else
+        {
+            SAFE_RELEASE( m_PendingBuffer );
+        }
+
+        if ( (SUCCEEDED( hr )) && (m_PendingBuffer != nullptr) )
+        {
+            // The queue is full, the rest of the sample waits until the endpoint has made room
+            m_PoolMissCount++;
+        }
+    }
+
     if (SUCCEEDED( hr ))
     {
-        // Pre-roll PREROLL_DURATION seconds worth of data
+        // Pre-roll PREROLL_DURATION seconds worth of data, or as much as fits into the queue
         if (m_ReaderState == ReaderStatePreRoll)
         {
-            if (IsPreRollFilled())
+            if ( (m_SampleQueue.GetReadableBytes() >= (m_MixFormat->nAvgBytesPerSec * PREROLL_DURATION_SEC)) ||
+                 (m_PendingBuffer != nullptr) )
             {
                 // Once Pre-roll is filled, audio endpoint will stop rendering silence and start
                 // picking up data from the queue
@@ -388,13 +429,55 @@ HRESULT MFSampleGenerator::OnReadSample(_In_ HRESULT hrStatus, _In_ DWORD dwStre
             }
         }
 
-        // Call ReadSample for next asynchronous sample event
-        hr = m_MFSourceReader->ReadSample( MF_SOURCE_READER_FIRST_AUDIO_STREAM, 0, nullptr, nullptr, nullptr, nullptr );
+        if ( (m_PendingBuffer != nullptr) ||
+             (m_SampleQueue.GetReadableBytes() >= m_cbHighWatermark) )
+        {
+            // Stop decoding ahead, FillSampleBuffer resumes reading when the queue has drained.
+            // The queue may have drained before the flag was set, so check right away as well.
+            InterlockedExchange( &m_ReadPaused, 1 );
+            ResumeReading();
+        }
+        else
+        {
+            // Call ReadSample for next asynchronous sample event
+            hr = m_MFSourceReader->ReadSample( MF_SOURCE_READER_FIRST_AUDIO_STREAM, 0, nullptr, nullptr, nullptr, nullptr );
+        }
     }
 
     return S_OK;
 }
 
+//
+//  ResumeReading()
+//
+//  Requests the next sample if reading was paused and the queue has drained to the low
+//  watermark.  Called from both the source reader and the audio endpoint threads, the
+//  exchange of m_ReadPaused makes sure only one of them writes to the queue or issues
+//  the request.  The rest of a pending sample is queued first; the next sample is only
+//  read once all of it is in the queue.
+//
+void MFSampleGenerator::ResumeReading()
+{
+    if ( (m_ReaderState != ReaderStatePlaying) &&
+         (m_ReaderState != ReaderStatePreRoll) )
+        return;
+
+    if ( (m_SampleQueue.GetReadableBytes() <= m_cbLowWatermark) &&
+         (InterlockedCompareExchange( &m_ReadPaused, 0, 1 ) == 1) )
+    {
+        // A buffer that fails to lock is dropped, and reading goes on with the next sample
+        QueuePendingBuffer();
+        if (m_PendingBuffer != nullptr)
+        {
+            // Still more than fits, wait for the queue to drain again
+            InterlockedExchange( &m_ReadPaused, 1 );
+            return;
+        }
+
+        m_MFSourceReader->ReadSample( MF_SOURCE_READER_FIRST_AUDIO_STREAM, 0, nullptr, nullptr, nullptr, nullptr );
+    }
+}
+
 //
 //  FillSampleBuffer()
 //
@@ -421,168 +504,101 @@ HRESULT MFSampleGenerator::FillSampleBuffer( UINT32 BytesToRead, BYTE *Data, UIN
     if (m_ReaderState == ReaderStatePreRoll)
         return S_OK;
 
-    RenderBuffer *SampleBuffer = m_SampleQueue;
-    if (nullptr == SampleBuffer)
+    UINT32 cbQueued = m_SampleQueue.GetReadableBytes();
+    if ( (cbQueued == 0) && (m_ReaderState == ReaderStateEOS) )
     {
-        if (m_ReaderState == ReaderStateEOS)
-        {
-            // We are EOS, should be set from OnReadSample() and the client should check for EOS before
-            // calling FillSampleBuffer()
-            hr = S_FALSE;
-        }
-        else
-        {
-            // There shouldn't be a situation where we get here unless the reader has
-            // somehow gotten into the wrong state
-            hr = E_FAIL;
-        }
+        // We are EOS, should be set from OnReadSample() and the client should check for EOS before
+        // calling FillSampleBuffer()
+        return S_FALSE;
     }
-    else
+
+    // Copy whole frames straight out of the queue
+    UINT32 cbToCopy = min( BytesToRead, cbQueued );
+    cbToCopy -= cbToCopy % m_MixFormat->nBlockAlign;
+
+    if ( (cbToCopy < BytesToRead) && (m_ReaderState != ReaderStateEOS) )
     {
-        if (SampleBuffer->BufferSize > BytesToRead)
-        {
-            // We don't have enough data in the client audio buffer this pass
-            // Do nothing and wait for the next sample period
-            hr = S_OK;
-        }
-        else
-        {
-            CopyMemory( Data, SampleBuffer->Buffer, SampleBuffer->BufferSize );
+        // The source couldn't keep up, the rest of the endpoint buffer stays silent
+        m_UnderrunCount++;
+    }
 
-            *cbWritten = SampleBuffer->BufferSize;
-            m_SampleQueue = m_SampleQueue->Next;
-            hr = S_OK;
-        }
+    m_SampleQueue.Read( Data, cbToCopy );
+    *cbWritten = cbToCopy;
+
+    if (m_ReaderState == ReaderStatePlaying)
+    {
+        // The queue drains at the end of the file, that doesn't count
+        m_cbMinQueued = min( m_cbMinQueued, cbQueued - cbToCopy );
     }
 
+    // Decode more samples if the queue is running low
+    ResumeReading();
+
     return hr;
 }
 
 //
-//  AddSamplesToBuffer()
+//  GetMinQueuedMilliseconds()
 //
-//  Data is added to the end of the sample queue
+//  The least amount of data that was left in the queue after filling the endpoint buffer
 //
-HRESULT MFSampleGenerator::AddSamplesToQueue( IMFSample *MFSample )
+UINT32 MFSampleGenerator::GetMinQueuedMilliseconds()
 {
-    if (nullptr == MFSample)
+    if ( (m_cbMinQueued == UINT_MAX) || (m_MixFormat == nullptr) )
     {
-        return E_INVALIDARG;
+        return 0;
     }
 
-    HRESULT hr = S_OK;
-    IMFMediaBuffer *MediaBuffer = nullptr;
-    BYTE *AudioData = nullptr;
-    DWORD cbAudioData = 0;
-
-    // Since we are storing the raw byte data, convert this to a single buffer
-    hr = MFSample->ConvertToContiguousBuffer( &MediaBuffer );
-    if (FAILED( hr ))
-    {
-        goto exit;
-    }
+    return (UINT32)( ((UINT64)m_cbMinQueued * 1000) / m_MixFormat->nAvgBytesPerSec );
+}
 
-    // Lock the sample
-    hr = MediaBuffer->Lock( &AudioData, NULL, &cbAudioData );
-    if ( (FAILED( hr )) || (cbAudioData == 0) )
+//
+//  QueuePendingBuffer()
+//
+//  Copies as many whole frames of the pending buffer to the end of the sample queue as fit,
+//  and releases the buffer once all of it has been queued.  The buffer is already contiguous,
+//  so this doesn't allocate and can run on the audio endpoint thread.
+//
+HRESULT MFSampleGenerator::QueuePendingBuffer()
+{
+    if (nullptr == m_PendingBuffer)
     {
-        goto exit;
+        return S_OK;
     }
 
-    DWORD cbBytesCopied = 0;
-
-    // First fill up any partial buffers from the previous sample
-    if ( (*m_SampleQueueTail != nullptr) &&
-         ((*m_SampleQueueTail)->BytesFilled < m_BytesPerPeriod) )
-    {
-        RenderBuffer *PartialBuffer = *m_SampleQueueTail;
-
-        DWORD cbBytesRemaining = m_BytesPerPeriod - PartialBuffer->BytesFilled;
-        DWORD cbBytesToCopy = min( cbAudioData, cbBytesRemaining );
-
-        CopyMemory( PartialBuffer->Buffer + PartialBuffer->BytesFilled, AudioData, cbBytesToCopy );
-
-        PartialBuffer->BytesFilled += cbBytesToCopy;
-        cbBytesCopied += cbBytesToCopy;
+    HRESULT hr = S_OK;
+    BYTE *AudioData = nullptr;
+    DWORD cbAudioData = 0;
 
-        // Move the tail pointer only if we have filled the sample
-        if (PartialBuffer->BytesFilled == m_BytesPerPeriod)
-        {
-            m_SampleQueueTail = &PartialBuffer->Next;
-        }
-    }
+    UINT32 cbWritable = m_SampleQueue.GetWritableBytes();
+    cbWritable -= cbWritable % m_MixFormat->nBlockAlign;
 
-    // Create buffers for the remainder of the samples
-    while( cbBytesCopied < cbAudioData )
+    DWORD cbToWrite = min( cbWritable, m_cbPendingBuffer - m_cbPendingQueued );
+    if (cbToWrite > 0)
     {
-        RenderBuffer *SampleBuffer = new (std::nothrow) RenderBuffer();
-        if (nullptr == SampleBuffer)
-        {
-            hr = E_OUTOFMEMORY;
-            goto exit;
-        }
-
-        DWORD cbBytesRemaining = cbAudioData - cbBytesCopied;
-        DWORD cbBufferLengthInBytes = min( m_BytesPerPeriod, cbBytesRemaining );
-
-        SampleBuffer->Buffer = new (std::nothrow) BYTE[ m_BytesPerPeriod ];
-        if (nullptr == SampleBuffer->Buffer)
+        // Lock the buffer
+        hr = m_PendingBuffer->Lock( &AudioData, NULL, &cbAudioData );
+        if (FAILED( hr ))
         {
-            SAFE_DELETE( SampleBuffer );
-            hr = E_OUTOFMEMORY;
             goto exit;
         }
 
-        SampleBuffer->BufferSize = m_BytesPerPeriod;
-        SampleBuffer->BytesFilled = 0;
-
-        ZeroMemory( SampleBuffer->Buffer, m_BytesPerPeriod );
-        CopyMemory( SampleBuffer->Buffer, AudioData + cbBytesCopied, cbBufferLengthInBytes );
-
-        SampleBuffer->BytesFilled += cbBufferLengthInBytes;
-        cbBytesCopied += cbBufferLengthInBytes;
-
-        *m_SampleQueueTail = SampleBuffer;
+        m_SampleQueue.Write( AudioData + m_cbPendingQueued, cbToWrite );
+        m_cbPendingQueued += cbToWrite;
 
-        // Move the tail pointer only if we have filled the sample otherwise will get filled the
-        // next time we add sample data to the queue
-        if (SampleBuffer->BytesFilled == m_BytesPerPeriod)
-        {
-            m_SampleQueueTail = &SampleBuffer->Next;
-        }
+        // Unlock the buffer
+        m_PendingBuffer->Unlock();
+        AudioData = nullptr;
     }
 
 exit:
-    // Unlock the buffer
-    hr = MediaBuffer->Unlock();
-    AudioData = nullptr;
-
-    SAFE_RELEASE( MediaBuffer );
-    return hr;
-}
-
-//
-//  IsPreRollFilled()
-//
-//  Loops through the queue quickly to see if our pre-roll buffer is filled
-//
-Platform::Boolean MFSampleGenerator::IsPreRollFilled()
-{
-    DWORD TotalBufferSize = 0;
-
-    RenderBuffer *SampleBuffer = m_SampleQueue;
-    while( SampleBuffer != nullptr )
+    if ( (FAILED( hr )) || (m_cbPendingQueued == m_cbPendingBuffer) )
     {
-        TotalBufferSize += SampleBuffer->BufferSize;
-
-        // For uncompressed formats, nAvgBytesPerSec should equal nSamplesPerSecond * nBlockAlign
-        if (TotalBufferSize >= (m_MixFormat->nAvgBytesPerSec * PREROLL_DURATION_SEC))
-        {
-            return true;
-        }
-
-        SampleBuffer = SampleBuffer->Next;
+        // All of it is queued, or it never will be
+        SAFE_RELEASE( m_PendingBuffer );
+        m_cbPendingBuffer = 0;
+        m_cbPendingQueued = 0;
     }
 
-    return false;
+    return hr;
 }
@@ -18,10 +18,14 @@
 #include <mfreadwrite.h>
 #include <mferror.h>
 #include "MainPage.xaml.h"
+#include "AudioRingBuffer.h"
 
 using namespace Windows::Storage::Streams;
 
 #define PREROLL_DURATION_SEC 3     // Arbitrary value for seconds of data in preroll buffer
+#define QUEUE_DURATION_SEC 4       // Seconds of data the sample queue can hold
+#define HIGH_WATERMARK_SEC 3       // Reading pauses when the queue holds this many seconds of data
+#define LOW_WATERMARK_SEC 1        // Reading resumes when the queue drains to this many seconds
 
 
 #pragma once
@@ -86,41 +90,59 @@ namespace SDKSample
             HRESULT StartSource();
             void StopSource();
 
-            HRESULT Initialize( IRandomAccessStream^ stream, UINT32 FramesPerPeriod, WAVEFORMATEX *wfx );
+            HRESULT Initialize( IRandomAccessStream^ stream, WAVEFORMATEX *wfx );
             void Shutdown();
             HRESULT FillSampleBuffer( UINT32 BytesToRead, BYTE *Data, UINT32 *cbWritten );
             void Flush();
 
             Platform::Boolean IsEOF()
             {
-                if ( ( m_SampleQueue == nullptr ) &&
+                if ( ( m_SampleQueue.GetReadableBytes() == 0 ) &&
                      ( m_ReaderState == ReaderStateEOS ) )
                     return true;
 
                 return false;
             }
 
+            // Playback statistics
+            UINT32 GetUnderrunCount() { return m_UnderrunCount; };
+            UINT32 GetPoolMissCount() { return m_PoolMissCount; };
+            UINT32 GetMinQueuedMilliseconds();
+
         private:
             ~MFSampleGenerator();
 
             HRESULT ConfigureStreams();
             HRESULT CreateAudioType( IMFMediaType **MediaType );
-            HRESULT AddSamplesToQueue( IMFSample *MFSample );
-            Platform::Boolean IsPreRollFilled();
+            HRESULT QueuePendingBuffer();
+            void ResumeReading();
 
         private:
             volatile ULONG          m_Ref;
             IRandomAccessStream^    m_ContentStream;
             WAVEFORMATEX           *m_MixFormat;
-            UINT32                  m_BytesPerPeriod;
             Platform::Boolean       m_IsInitialized;
 
             IMFSourceReader        *m_MFSourceReader;
             IMFMediaType           *m_AudioMT;
             ReaderState             m_ReaderState;
 
-            RenderBuffer           *m_SampleQueue;
-            RenderBuffer          **m_SampleQueueTail;
+            // The decoded samples are copied into a fixed size queue.  The reader stops requesting
+            // samples when the queue reaches the high watermark, and FillSampleBuffer requests them
+            // again once it has drained to the low watermark.  The part of a sample that doesn't fit
+            // into the queue is held in m_PendingBuffer and queued as room frees up, before the next
+            // sample is read, so samples larger than the queue are split across several writes.
+            AudioRingBuffer         m_SampleQueue;
+            UINT32                  m_cbHighWatermark;
+            UINT32                  m_cbLowWatermark;
+            volatile LONG           m_ReadPaused;
+            IMFMediaBuffer         *m_PendingBuffer;
+            DWORD                   m_cbPendingBuffer;
+            DWORD                   m_cbPendingQueued;     // Bytes of m_PendingBuffer already queued
+
+            UINT32                  m_UnderrunCount;
+            UINT32                  m_PoolMissCount;
+            UINT32                  m_cbMinQueued;
         };
     }
 }
@@ -17,18 +17,23 @@
 #pragma once
 
 #define MILLISECONDS_TO_VISUALIZE 20
+#define SCOPE_POINTS 240            // Minimum/maximum pairs per scope frame
+#define SCOPE_FRAME_BUFFERS 3
 
 namespace SDKSample
 {
     namespace WASAPIAudio
     {
-        // Class for PlotDataReady events
+        // Class for PlotDataReady events.  Points holds the minimum and maximum of each point of the
+        // frame, in the 16-bit range, followed by the full scale value.  Rms is the level of the
+        // whole frame relative to full scale.
         public ref class PlotDataReadyEventArgs sealed
         {
         internal:
-            PlotDataReadyEventArgs( Platform::Array<int, 1>^ points, UINT32 size ) :
+            PlotDataReadyEventArgs( Platform::Array<int, 1>^ points, UINT32 size, float rms ) :
                     m_PointArray( points ),
-                    m_Size( size )
+                    m_Size( size ),
+                    m_Rms( rms )
             {};
 
             property Platform::Array<int, 1>^ Points
@@ -41,9 +46,15 @@ namespace SDKSample
                 UINT32 get() { return m_Size; }
             };
 
+            property float Rms
+            {
+                float get() { return m_Rms; }
+            };
+
         private:
             Platform::Array<int,1>^     m_PointArray;
             UINT32                      m_Size;
+            float                       m_Rms;
         };
 
         // PlotDataReady delegate
@@ -56,9 +67,9 @@ namespace SDKSample
             PlotDataReadyEvent() {};
 
         internal:
-            static void SendEvent( Object^ obj, Platform::Array<int, 1>^ points, UINT32 size )
+            static void SendEvent( Object^ obj, Platform::Array<int, 1>^ points, UINT32 size, float rms )
             {
-                PlotDataReadyEventArgs^ e = ref new PlotDataReadyEventArgs( points, size );
+                PlotDataReadyEventArgs^ e = ref new PlotDataReadyEventArgs( points, size, rms );
                 PlotDataReady( obj, e );
             }
 
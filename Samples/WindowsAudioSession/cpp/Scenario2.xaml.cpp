@@ -356,17 +356,31 @@ void Scenario2::OnDeviceStateChange(Object^ sender, DeviceStateChangedEventArgs^
   break;
 
  case DeviceState::DeviceStateStopped:
-  m_spRenderer = nullptr;
-
-  if (m_deviceStateChangeToken.Value != 0)
   {
-   m_StateChangedEvent->StateChangedEvent -= m_deviceStateChangeToken;
-   m_StateChangedEvent = nullptr;
-   m_deviceStateChangeToken.Value = 0;
-  }
+   // Report how well the file source kept up before tearing down the renderer
+   String^ strMessage = "Playback Stopped";
+   UINT32 UnderrunCount = 0;
+   UINT32 PoolMissCount = 0;
+   UINT32 MinQueuedMilliseconds = 0;
 
-  ShowStatusMessage("Playback Stopped", NotifyType::StatusMessage);
-  m_SystemMediaControls->PlaybackStatus = MediaPlaybackStatus::Stopped;
+   if (m_spRenderer->GetSourceStatistics( &UnderrunCount, &PoolMissCount, &MinQueuedMilliseconds ) == S_OK)
+   {
+    strMessage += " (Underruns = " + UnderrunCount.ToString() + ", Pool Misses = " + PoolMissCount.ToString() +
+     ", Lowest Queue = " + MinQueuedMilliseconds.ToString() + " ms)";
+   }
+
+   m_spRenderer = nullptr;
+
+   if (m_deviceStateChangeToken.Value != 0)
+   {
+    m_StateChangedEvent->StateChangedEvent -= m_deviceStateChangeToken;
+    m_StateChangedEvent = nullptr;
+    m_deviceStateChangeToken.Value = 0;
+   }
+
+   ShowStatusMessage(strMessage, NotifyType::StatusMessage);
+   m_SystemMediaControls->PlaybackStatus = MediaPlaybackStatus::Stopped;
+  }
   break;
 
  case DeviceState::DeviceStateInError:
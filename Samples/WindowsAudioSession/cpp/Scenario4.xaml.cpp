@@ -230,6 +230,10 @@ void Scenario4::OnDeviceStateChange( Object^ sender, DeviceStateChangedEventArgs
         break;
 
     case DeviceState::DeviceStateStopped:
+        // Report how well the capture kept up before tearing it down
+        strMessage = "Capture Stopped (Overruns = " + m_spCapture->GetOverrunCount().ToString() +
+            ", Longest Callback = " + m_spCapture->GetMaxCallbackMicroseconds() + " us)";
+
         // For the stopped state, completely tear down the audio device
         m_spCapture = nullptr;
 
@@ -240,7 +244,7 @@ void Scenario4::OnDeviceStateChange( Object^ sender, DeviceStateChangedEventArgs
             m_deviceStateChangeToken.Value = 0;
         }
 
-        ShowStatusMessage( "Capture Stopped", NotifyType::StatusMessage );
+        ShowStatusMessage( strMessage, NotifyType::StatusMessage );
         break;
 
     case DeviceState::DeviceStateInError:
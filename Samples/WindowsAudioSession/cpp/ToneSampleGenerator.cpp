@@ -38,10 +38,15 @@ short Convert<short>(double Value)
 //
 //  ToneSampleGenerator()
 //
-ToneSampleGenerator::ToneSampleGenerator()
+ToneSampleGenerator::ToneSampleGenerator() :
+    m_SampleType( RenderSampleType::SampleTypeUnknown ),
+    m_ChannelCount( 0 ),
+    m_FramesRemaining( 0 ),
+    m_Cos( 1.0 ),
+    m_Sin( 0.0 ),
+    m_CosIncrement( 1.0 ),
+    m_SinIncrement( 0.0 )
 {
-    m_SampleQueue = nullptr;
-    m_SampleQueueTail = &m_SampleQueue;
 }
 
 //
@@ -49,119 +54,101 @@ ToneSampleGenerator::ToneSampleGenerator()
 //
 ToneSampleGenerator::~ToneSampleGenerator()
 {
-    // Flush unused samples
     Flush();
 }
 
 //
-//  GenerateSampleBuffer()
+//  Initialize()
 //
-//  Create a linked list of sample buffers
+//  Sets up the oscillator for a TONE_DURATION_SEC tone.  Nothing is generated until FillSampleBuffer
 //
-HRESULT ToneSampleGenerator::GenerateSampleBuffer( DWORD Frequency, UINT32 FramesPerPeriod, WAVEFORMATEX *wfx )
+HRESULT ToneSampleGenerator::Initialize( DWORD Frequency, WAVEFORMATEX *wfx )
 {
-    HRESULT hr = S_OK;
-
-    UINT32 renderBufferSizeInBytes = FramesPerPeriod * wfx->nBlockAlign;
-    UINT64 renderDataLength = ( wfx->nSamplesPerSec * TONE_DURATION_SEC * wfx->nBlockAlign ) + ( renderBufferSizeInBytes - 1 );
-    UINT64 renderBufferCount = renderDataLength / renderBufferSizeInBytes;
-
-    double theta = 0;
-
-    for( UINT64 i = 0; i < renderBufferCount; i++ )
+    m_SampleType = CalculateMixFormatType( wfx );
+    if ( (m_SampleType != RenderSampleType::SampleType16BitPCM) &&
+         (m_SampleType != RenderSampleType::SampleTypeFloat) )
     {
-        RenderBuffer *SampleBuffer = new (std::nothrow) RenderBuffer();
-        if (nullptr == SampleBuffer)
-        {
-            return E_OUTOFMEMORY;
-        }
-
-        SampleBuffer->BufferSize = renderBufferSizeInBytes;
-        SampleBuffer->BytesFilled = renderBufferSizeInBytes;
-        SampleBuffer->Buffer = new (std::nothrow) BYTE[ renderBufferSizeInBytes ];
-        if (nullptr == SampleBuffer->Buffer)
-        {
-            return E_OUTOFMEMORY;
-        }
-
-        switch( CalculateMixFormatType( wfx ) )
-        {
-        case RenderSampleType::SampleType16BitPCM:
-            GenerateSineSamples<short>( SampleBuffer->Buffer, SampleBuffer->BufferSize, Frequency, wfx->nChannels, wfx->nSamplesPerSec, TONE_AMPLITUDE, &theta);
-            break;
+        return E_UNEXPECTED;
+    }
 
-        case RenderSampleType::SampleTypeFloat:
-            GenerateSineSamples<float>( SampleBuffer->Buffer, SampleBuffer->BufferSize, Frequency, wfx->nChannels, wfx->nSamplesPerSec, TONE_AMPLITUDE, &theta);
-            break;
+    double sampleIncrement = (Frequency * (M_PI*2)) / (double)wfx->nSamplesPerSec;
 
-        default:
-            return E_UNEXPECTED;
-            break;
-        }
+    m_ChannelCount = wfx->nChannels;
+    m_FramesRemaining = (UINT64)wfx->nSamplesPerSec * TONE_DURATION_SEC;
+    m_Cos = 1.0;
+    m_Sin = 0.0;
+    m_CosIncrement = cos( sampleIncrement );
+    m_SinIncrement = sin( sampleIncrement );
 
-        *m_SampleQueueTail = SampleBuffer;
-        m_SampleQueueTail = &SampleBuffer->Next;
-    }
-    return hr;
+    return S_OK;
 }
 
 //
 // GenerateSineSamples()
 //
-//  Generate samples which represent a sine wave that fits into the specified buffer.
+//  Generate samples which continue the sine wave from the previous call.
 //
-//  T:  Type of data holding the sample (short, int, byte, float)
+//  T:  Type of data holding the sample (short, float)
 //  Buffer - Buffer to hold the samples
-//  BufferLength - Length of the buffer.
-//  ChannelCount - Number of channels per audio frame.
-//  SamplesPerSecond - Samples/Second for the output data.
-//  InitialTheta - Initial theta value - start at 0, modified in this function.
+//  FrameCount - Number of audio frames to generate.
 //
 template <typename T>
-void ToneSampleGenerator::GenerateSineSamples(BYTE *Buffer, size_t BufferLength, DWORD Frequency, WORD ChannelCount, DWORD SamplesPerSecond, double Amplitude, double *InitialTheta)
+void ToneSampleGenerator::GenerateSineSamples( BYTE *Buffer, UINT32 FrameCount )
 {
-    double sampleIncrement = (Frequency * (M_PI*2)) / (double)SamplesPerSecond;
     T *dataBuffer = reinterpret_cast<T *>(Buffer);
-    double theta = (InitialTheta != NULL ? *InitialTheta : 0);
+    double c = m_Cos;
+    double s = m_Sin;
 
-    for (size_t i = 0 ; i < BufferLength / sizeof(T) ; i += ChannelCount)
+    for (UINT32 i = 0; i < FrameCount; i++)
     {
-        double sinValue = Amplitude * sin( theta );
-        for(size_t j = 0 ;j < ChannelCount; j++)
+        T sample = Convert<T>( TONE_AMPLITUDE * s );
+        for (WORD j = 0; j < m_ChannelCount; j++)
         {
-            dataBuffer[i+j] = Convert<T>(sinValue);
+            *dataBuffer++ = sample;
         }
-        theta += sampleIncrement;
-    }
 
-    if (InitialTheta != NULL)
-    {
-        *InitialTheta = theta;
+        // Rotate the phasor by the phase increment: (c + is) * (cos + isin)
+        double cNext = c * m_CosIncrement - s * m_SinIncrement;
+        s = s * m_CosIncrement + c * m_SinIncrement;
+        c = cNext;
     }
+
+    // Rounding errors slowly change the length of the phasor, so scale it back to 1 once per buffer
+    double scale = 1.0 / sqrt( c * c + s * s );
+    m_Cos = c * scale;
+    m_Sin = s * scale;
 }
 
 //
 //  FillSampleBuffer()
 //
-//  File the Data buffer of size BytesToRead with the first item in the queue.  Caller is responsible for allocating and freeing buffer
+//  Generates up to FramesToWrite frames of the tone into Data.  Caller is responsible for allocating and freeing buffer
 //
-HRESULT ToneSampleGenerator::FillSampleBuffer( UINT32 BytesToRead, BYTE *Data )
+HRESULT ToneSampleGenerator::FillSampleBuffer( UINT32 FramesToWrite, BYTE *Data, UINT32 *FramesWritten )
 {
-    if (nullptr == Data)
+    if ( (nullptr == Data) || (nullptr == FramesWritten) )
     {
         return E_POINTER;
     }
 
-    RenderBuffer *SampleBuffer = m_SampleQueue;
+    UINT32 FrameCount = (UINT32)min( (UINT64)FramesToWrite, m_FramesRemaining );
 
-    if (BytesToRead > SampleBuffer->BufferSize)
+    switch( m_SampleType )
     {
-        return E_INVALIDARG;
-    }
+    case RenderSampleType::SampleType16BitPCM:
+        GenerateSineSamples<short>( Data, FrameCount );
+        break;
 
-    CopyMemory( Data, SampleBuffer->Buffer, BytesToRead );
+    case RenderSampleType::SampleTypeFloat:
+        GenerateSineSamples<float>( Data, FrameCount );
+        break;
 
-    m_SampleQueue = m_SampleQueue->Next;
+    default:
+        return E_UNEXPECTED;
+    }
+
+    m_FramesRemaining -= FrameCount;
+    *FramesWritten = FrameCount;
 
     return S_OK;
 }
@@ -169,15 +156,9 @@ HRESULT ToneSampleGenerator::FillSampleBuffer( UINT32 BytesToRead, BYTE *Data )
 //
 //  Flush()
 //
-//  Remove and free unused samples from the queue
+//  Ends the tone
 //
 void ToneSampleGenerator::Flush()
 {
-    while( m_SampleQueue != nullptr )
-    {
-        RenderBuffer *SampleBuffer = m_SampleQueue;
-        m_SampleQueue = SampleBuffer->Next;
-        SAFE_DELETE( SampleBuffer );
-    }
+    m_FramesRemaining = 0;
 }
-
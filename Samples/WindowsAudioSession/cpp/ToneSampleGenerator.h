@@ -25,26 +25,37 @@ namespace SDKSample
 {
  namespace WASAPIAudio
  {
+  // Synthesizes the tone while it is being played, straight into the buffer passed to
+  // FillSampleBuffer.  The sine wave is computed with a rotating phasor (one complex multiply per
+  // frame) instead of sin(), and no memory is allocated after Initialize, so the memory use
+  // doesn't depend on the length of the tone.
   class ToneSampleGenerator
   {
    public:
    ToneSampleGenerator();
    ~ToneSampleGenerator();
     
-   Platform::Boolean IsEOF(){ return (m_SampleQueue == nullptr);  };
-   UINT32 GetBufferLength(){ return (m_SampleQueue !=  nullptr ? m_SampleQueue->BufferSize : 0 ); };
+   Platform::Boolean IsEOF(){ return (m_FramesRemaining == 0);  };
    void Flush();
 
-   HRESULT GenerateSampleBuffer(DWORD Frequency, UINT32 FramesPerPeriod, WAVEFORMATEX *wfx);
-   HRESULT FillSampleBuffer(UINT32 BytesToRead, BYTE *Data);
+   HRESULT Initialize(DWORD Frequency, WAVEFORMATEX *wfx);
+   HRESULT FillSampleBuffer(UINT32 FramesToWrite, BYTE *Data, UINT32 *FramesWritten);
 
    private:
    template <typename T>
-   void GenerateSineSamples(BYTE *Buffer, size_t BufferLength, DWORD Frequency, WORD ChannelCount, DWORD SamplesPerSecond, double Amplitude, double *InitialTheta);
+   void GenerateSineSamples(BYTE *Buffer, UINT32 FrameCount);
 
    private:
-   RenderBuffer *m_SampleQueue;
-   RenderBuffer **m_SampleQueueTail;
+   RenderSampleType m_SampleType;
+   WORD             m_ChannelCount;
+   UINT64           m_FramesRemaining;
+
+   // Oscillator state: the current phasor (cos, sin of theta) and the phasor of the per-frame
+   // phase increment
+   double           m_Cos;
+   double           m_Sin;
+   double           m_CosIncrement;
+   double           m_SinIncrement;
   };
  }
 }
@@ -14,6 +14,8 @@
 
 #include "pch.h"
 #include "WASAPICapture.h"
+#include <limits.h>
+#include <math.h>
 
 using namespace Windows::Storage;
 using namespace Windows::System::Threading;
@@ -28,7 +30,7 @@ WASAPICapture::WASAPICapture() :
     m_BufferFrames( 0 ),
     m_cbDataSize( 0 ),
     m_cbHeaderSize( 0 ),
-    m_cbFlushCounter( 0 ),
+    m_cbCaptured( 0 ),
     m_dwQueueID( 0 ),
     m_DeviceStateChanged( nullptr ),
     m_AudioClient( nullptr ),
@@ -37,8 +39,22 @@ WASAPICapture::WASAPICapture() :
     m_ContentStream( nullptr ),
     m_OutputStream( nullptr ),
     m_WAVDataWriter( nullptr ),
-    m_PlotData( nullptr ),
-    m_fWriting( false )
+    m_cScopeWindowFrames( 0 ),
+    m_cScopeBucketFrames( 0 ),
+    m_cScopeBucketFilled( 0 ),
+    m_cScopePoint( 0 ),
+    m_iScopeFrame( 0 ),
+    m_fScopeFloat( FALSE ),
+    m_ScopeMin( INT_MAX ),
+    m_ScopeMax( INT_MIN ),
+    m_ScopeSumSquares( 0.0 ),
+    m_WriterEvent( nullptr ),
+    m_WriteChunk( nullptr ),
+    m_cbWriteChunk( 0 ),
+    m_fWriterStarted( false ),
+    m_fStopWriter( false ),
+    m_OverrunCount( 0 ),
+    m_MaxCallbackTicks( 0 )
 {
     // Create events for sample ready or user stop
     m_SampleReadyEvent = CreateEventEx( nullptr, nullptr, 0, EVENT_ALL_ACCESS );
@@ -47,11 +63,15 @@ WASAPICapture::WASAPICapture() :
         ThrowIfFailed( HRESULT_FROM_WIN32( GetLastError() ) );
     }
 
-    if (!InitializeCriticalSectionEx( &m_CritSec, 0, 0 ))
+    // Create the event that wakes up the file writer
+    m_WriterEvent = CreateEventEx( nullptr, nullptr, 0, EVENT_ALL_ACCESS );
+    if (nullptr == m_WriterEvent)
     {
         ThrowIfFailed( HRESULT_FROM_WIN32( GetLastError() ) );
     }
 
+    QueryPerformanceFrequency( &m_QPCFrequency );
+
     m_DeviceStateChanged = ref new DeviceStateChangedEvent();
     if (nullptr == m_DeviceStateChanged)
     {
@@ -87,16 +107,24 @@ WASAPICapture::~WASAPICapture()
         m_SampleReadyEvent = INVALID_HANDLE_VALUE;
     }
 
+    if (nullptr != m_WriterEvent)
+    {
+        CloseHandle( m_WriterEvent );
+        m_WriterEvent = nullptr;
+    }
+
     MFUnlockWorkQueue( m_dwQueueID );
 
     m_DeviceStateChanged = nullptr;
     m_ContentStream = nullptr;
     m_OutputStream = nullptr;
     m_WAVDataWriter = nullptr;
+    m_WriteChunk = nullptr;
 
-    m_PlotData = nullptr;
-
-    DeleteCriticalSection( &m_CritSec );
+    for (UINT32 i = 0; i < SCOPE_FRAME_BUFFERS; i++)
+    {
+        m_ScopeFrames[i] = nullptr;
+    }
 }
 
 //
@@ -287,6 +315,13 @@ HRESULT WASAPICapture::ActivateCompleted( IActivateAudioInterfaceAsyncOperation
         goto exit;
     }
 
+    // Allocate the buffers between the capture callback and the file writer
+    hr = InitializeCaptureBuffer();
+    if (FAILED( hr ))
+    {
+        goto exit;
+    }
+
     // Creates the WAV file.  If successful, will set the Initialized event
     hr = CreateWAVFile();
     if (FAILED( hr ))
@@ -444,29 +479,82 @@ HRESULT WASAPICapture::FixWAVHeader()
 //
 HRESULT WASAPICapture::InitializeScopeData()
 {
-    HRESULT hr = S_OK;
-
-    m_cPlotDataFilled = 0;
-    m_cPlotDataMax = (MILLISECONDS_TO_VISUALIZE * m_MixFormat->nSamplesPerSec) / 1000;
+    m_cScopeWindowFrames = (MILLISECONDS_TO_VISUALIZE * m_MixFormat->nSamplesPerSec) / 1000;
+    m_cScopePoint = 0;
+    m_cScopeBucketFilled = 0;
+    m_cScopeBucketFrames = m_cScopeWindowFrames / SCOPE_POINTS;
+    m_ScopeMin = INT_MAX;
+    m_ScopeMax = INT_MIN;
+    m_ScopeSumSquares = 0.0;
+    m_iScopeFrame = 0;
+
+    for (UINT32 i = 0; i < SCOPE_FRAME_BUFFERS; i++)
+    {
+        m_ScopeFrames[i] = nullptr;
+    }
 
-    m_PlotData = ref new Platform::Array<int, 1>( m_cPlotDataMax + 1 );
-    if (nullptr == m_PlotData)
+    // The window has to hold at least one frame per point
+    if (m_cScopeBucketFrames == 0)
     {
-        return E_OUTOFMEMORY;
+        return S_FALSE;
     }
 
-    // Only Support 16 bit Audio for now
-    if (m_MixFormat->wBitsPerSample == 16)
+    // Integer PCM of 16, 24 or 32 bits and 32-bit float are supported
+    WORD wBitsPerSample = m_MixFormat->wBitsPerSample;
+    if (CalculateMixFormatType( m_MixFormat ) == RenderSampleType::SampleTypeFloat)
     {
-        m_PlotData[ m_cPlotDataMax ] = -32768;  // INT16_MAX
+        m_fScopeFloat = TRUE;
+        if (wBitsPerSample != 32)
+        {
+            return S_FALSE;
+        }
     }
     else
     {
-        m_PlotData = nullptr;
-        hr = S_FALSE;
+        m_fScopeFloat = FALSE;
+        if (wBitsPerSample != 16 && wBitsPerSample != 24 && wBitsPerSample != 32)
+        {
+            return S_FALSE;
+        }
     }
 
-    return hr;
+    // The UI may still be drawing the previous frame when the next one is filled, so rotate
+    // between a few arrays
+    for (UINT32 i = 0; i < SCOPE_FRAME_BUFFERS; i++)
+    {
+        m_ScopeFrames[i] = ref new Platform::Array<int, 1>( SCOPE_POINTS * 2 + 1 );
+        if (nullptr == m_ScopeFrames[i])
+        {
+            return E_OUTOFMEMORY;
+        }
+
+        m_ScopeFrames[i][ SCOPE_POINTS * 2 ] = -32768;  // INT16_MIN
+    }
+
+    return S_OK;
+}
+
+//
+//  InitializeCaptureBuffer()
+//
+//  Allocates the ring buffer filled by the capture callback and the chunk used to write it to
+//  the file.  Everything is allocated up front so the capture callback never allocates memory.
+//
+HRESULT WASAPICapture::InitializeCaptureBuffer()
+{
+    // Chunks are a whole number of frames and a multiple of 4KB
+    m_cbWriteChunk = WRITE_CHUNK_FRAMES * m_MixFormat->nBlockAlign;
+
+    m_WriteChunk = ref new Platform::Array<BYTE>( m_cbWriteChunk );
+    if (nullptr == m_WriteChunk)
+    {
+        return E_OUTOFMEMORY;
+    }
+
+    // Hold a few seconds of audio so the capture continues while the file system is slow
+    UINT32 cbCapacity = max( m_MixFormat->nAvgBytesPerSec * RING_BUFFER_SEC, m_cbWriteChunk * 2 );
+
+    return m_CaptureBuffer.Initialize( cbCapacity );
 }
 
 //
@@ -498,6 +586,9 @@ HRESULT WASAPICapture::OnStartCapture( IMFAsyncResult* pResult )
 {
     HRESULT hr = S_OK;
 
+    // The writer has to be running before samples arrive
+    StartWriter();
+
     // Start the capture
     hr = m_AudioClient->Start();
     if (SUCCEEDED( hr ))
@@ -549,21 +640,122 @@ HRESULT WASAPICapture::OnStopCapture( IMFAsyncResult* pResult )
     m_AudioClient->Stop();
     SAFE_RELEASE( m_SampleReadyAsyncResult );
 
-    // If this is set, it means we writing from the memory buffer to the actual file asynchronously
-    // Since a second call to StoreAsync() can cause an exception, don't queue this now, but rather
-    // let the async operation completion handle the call.
-    if (!m_fWriting)
+    m_DeviceStateChanged->SetState( DeviceState::DeviceStateFlushing, S_OK, true );
+
+    if (m_fWriterStarted)
+    {
+        // The writer stores the rest of the captured data and then finalizes the WAV header
+        m_fStopWriter = true;
+        SetEvent( m_WriterEvent );
+    }
+    else
     {
-        m_DeviceStateChanged->SetState( DeviceState::DeviceStateFlushing, S_OK, true );
+        FinishCaptureAsync();
+    }
 
-        concurrency::task<unsigned int>( m_WAVDataWriter->StoreAsync()).then(
-            [this]( unsigned int BytesWritten )
+    return S_OK;
+}
+
+//
+//  StartWriter()
+//
+//  Starts the long running work item that writes the captured data to the file
+//
+void WASAPICapture::StartWriter()
+{
+    ComPtr<WASAPICapture> spThis = this;
+
+    m_fStopWriter = false;
+    m_fWriterStarted = true;
+
+    ThreadPool::RunAsync( ref new WorkItemHandler(
+        [spThis]( Windows::Foundation::IAsyncAction^ action )
+    {
+        spThis->WriterProc();
+    }), WorkItemPriority::Normal, WorkItemOptions::TimeSliced );
+}
+
+//
+//  WriterProc()
+//
+//  Waits for the capture callback to fill a chunk and writes it to the file, until the capture
+//  is stopped.  Blocking on the file here keeps the file system off the capture thread.
+//
+void WASAPICapture::WriterProc()
+{
+    BOOL fStopping = false;
+
+    try
+    {
+        while (!fStopping)
         {
-            FinishCaptureAsync();
-        });
+            WaitForSingleObjectEx( m_WriterEvent, INFINITE, FALSE );
+
+            // Read the flag before draining, so everything captured before the stop is written
+            fStopping = m_fStopWriter;
+            WriteCapturedData( fStopping );
+        }
+    }
+    catch (Platform::Exception ^e)
+    {
+        m_DeviceStateChanged->SetState( DeviceState::DeviceStateInError, e->HResult, true );
+        return;
     }
 
-    return S_OK;
+    FinishCaptureAsync();
+}
+
+//
+//  WriteCapturedData()
+//
+//  Writes the complete chunks in the capture buffer to the file.  On the final call the
+//  partial chunk at the end is written as well.
+//
+void WASAPICapture::WriteCapturedData( BOOL fFinal )
+{
+    DWORD cbWritten = 0;
+
+    for (;;)
+    {
+        UINT32 cbChunk = min( m_CaptureBuffer.GetReadableBytes(), m_cbWriteChunk );
+
+        if ( (cbChunk == 0) || ((cbChunk < m_cbWriteChunk) && !fFinal) )
+        {
+            break;
+        }
+
+        if (cbChunk == m_cbWriteChunk)
+        {
+            m_CaptureBuffer.Read( m_WriteChunk->Data, cbChunk );
+            m_WAVDataWriter->WriteBytes( m_WriteChunk );
+        }
+        else
+        {
+            auto LastChunk = ref new Platform::Array<BYTE>( cbChunk );
+            m_CaptureBuffer.Read( LastChunk->Data, cbChunk );
+            m_WAVDataWriter->WriteBytes( LastChunk );
+        }
+
+        cbWritten += cbChunk;
+    }
+
+    if (cbWritten > 0)
+    {
+        concurrency::create_task( m_WAVDataWriter->StoreAsync() ).get();
+
+        // Only count the data that made it to the file, so the WAV header matches the file
+        m_cbDataSize += cbWritten;
+    }
+}
+
+//
+//  GetMaxCallbackMicroseconds()
+//
+//  Longest time spent in the capture callback
+//
+UINT32 WASAPICapture::GetMaxCallbackMicroseconds()
+{
+    return static_cast<UINT32>( (m_MaxCallbackTicks * 1000000) / m_QPCFrequency.QuadPart );
 }
 
 //
@@ -636,8 +828,10 @@ HRESULT WASAPICapture::OnAudioSampleRequested( Platform::Boolean IsSilence )
     UINT64 u64DevicePosition = 0;
     UINT64 u64QPCPosition = 0;
     DWORD cbBytesToCapture = 0;
+    LARGE_INTEGER StartTime;
+    LARGE_INTEGER EndTime;
 
-    EnterCriticalSection( &m_CritSec );
+    QueryPerformanceCounter( &StartTime );
 
     // If this flag is set, we have already queued up the async call to finialize the WAV header
     // So we don't want to grab or write any more data that would possibly give us an invalid size
@@ -678,7 +872,7 @@ HRESULT WASAPICapture::OnAudioSampleRequested( Platform::Boolean IsSilence )
         
         // WAV files have a 4GB (0xFFFFFFFF) size limit, so likely we have hit that limit when we
         // overflow here.  Time to stop the capture
-        if ( (m_cbDataSize + cbBytesToCapture) < m_cbDataSize )
+        if ( (m_cbCaptured + cbBytesToCapture) < m_cbCaptured )
         {
             StopCaptureAsync();
             goto exit;
@@ -704,98 +898,203 @@ HRESULT WASAPICapture::OnAudioSampleRequested( Platform::Boolean IsSilence )
             memset( Data, 0, FramesAvailable * m_MixFormat->nBlockAlign );
         }
 
-        // Store data in array
-        auto dataByte = ref new Platform::Array<BYTE, 1>( Data, cbBytesToCapture );
+        // Copy the samples for the writer.  If the writer has fallen too far behind, the packet
+        // is dropped rather than waiting for it
+        if (m_CaptureBuffer.Write( Data, cbBytesToCapture ))
+        {
+            m_cbCaptured += cbBytesToCapture;
+        }
+        else
+        {
+            m_OverrunCount++;
+        }
+
+        // Update plotter data
+        ProcessScopeData( Data, cbBytesToCapture );
 
         // Release buffer back
         m_AudioCaptureClient->ReleaseBuffer( FramesAvailable );
+    }
 
-        // Update plotter data
-        ProcessScopeData( Data, cbBytesToCapture );
+    // Wake up the writer once there is a chunk to write
+    if (m_CaptureBuffer.GetReadableBytes() >= m_cbWriteChunk)
+    {
+        SetEvent( m_WriterEvent );
+    }
 
-        // Write File and async store
-        m_WAVDataWriter->WriteBytes( dataByte );
+exit:
+    QueryPerformanceCounter( &EndTime );
+    m_MaxCallbackTicks = max( m_MaxCallbackTicks, EndTime.QuadPart - StartTime.QuadPart );
 
-        // Increase the size of our 'data' chunk and flush counter.  m_cbDataSize needs to be accurate
-        // Its OK if m_cbFlushCounter is an approximation
-        m_cbDataSize += cbBytesToCapture;
-        m_cbFlushCounter += cbBytesToCapture;
+    return hr;
+}
 
-        if ( (m_cbFlushCounter > ( m_MixFormat->nAvgBytesPerSec * FLUSH_INTERVAL_SEC )) && !m_fWriting )
-        {
-            // Set this flag when about to commit the async storage operation.  We don't want to 
-            // accidently call stop and finalize the WAV header or run into a scenario where the 
-            // store operation takes longer than FLUSH_INTERVAL_SEC as multiple concurrent calls 
-            // to StoreAsync() can cause an exception
-            m_fWriting = true;
+//
+//  ScanSamples()
+//
+//  Updates the minimum, maximum and sum of squares with a run of samples, scaled to the 16-bit
+//  range.  The loops only keep running values so the compiler can vectorize them.
+//
+static void ScanSamples16( const INT16 *Samples, UINT32 Count, int *Min, int *Max, double *SumSquares )
+{
+    int Low = *Min;
+    int High = *Max;
+    float Sum = 0.0f;
 
-            // Reset the counter now since we can process more samples during the async callback
-            m_cbFlushCounter = 0;
+    for (UINT32 i = 0; i < Count; i++)
+    {
+        int Value = Samples[i];
+        Low = min( Low, Value );
+        High = max( High, Value );
+        Sum += static_cast<float>( Value ) * static_cast<float>( Value );
+    }
 
-            concurrency::task<unsigned int>( m_WAVDataWriter->StoreAsync()).then(
-                [this]( unsigned int BytesWritten )
-            {
-                m_fWriting = false;
-
-                // We need to check for StopCapture while we are flusing the file.  If it has come through, then we
-                // can go ahead and call FinisheCaptureAsync() to write the WAV header
-                if (m_DeviceStateChanged->GetState() == DeviceState::DeviceStateStopping)
-                {
-                    m_DeviceStateChanged->SetState( DeviceState::DeviceStateFlushing, S_OK, true );
-                    FinishCaptureAsync();
-                }
-            });
-        }
+    *Min = Low;
+    *Max = High;
+    *SumSquares += Sum;
+}
+
+static void ScanSamples24( const BYTE *Samples, UINT32 Count, int *Min, int *Max, double *SumSquares )
+{
+    int Low = *Min;
+    int High = *Max;
+    float Sum = 0.0f;
+
+    // Packed little endian samples, only the two high bytes are needed
+    for (UINT32 i = 0; i < Count; i++)
+    {
+        int Value = static_cast<INT16>( Samples[i * 3 + 1] | (Samples[i * 3 + 2] << 8) );
+        Low = min( Low, Value );
+        High = max( High, Value );
+        Sum += static_cast<float>( Value ) * static_cast<float>( Value );
     }
 
-exit:
-    LeaveCriticalSection( &m_CritSec );
+    *Min = Low;
+    *Max = High;
+    *SumSquares += Sum;
+}
 
-    return hr;
+static void ScanSamples32( const INT32 *Samples, UINT32 Count, int *Min, int *Max, double *SumSquares )
+{
+    int Low = *Min;
+    int High = *Max;
+    float Sum = 0.0f;
+
+    for (UINT32 i = 0; i < Count; i++)
+    {
+        int Value = Samples[i] >> 16;
+        Low = min( Low, Value );
+        High = max( High, Value );
+        Sum += static_cast<float>( Value ) * static_cast<float>( Value );
+    }
+
+    *Min = Low;
+    *Max = High;
+    *SumSquares += Sum;
+}
+
+static void ScanSamplesFloat( const float *Samples, UINT32 Count, int *Min, int *Max, double *SumSquares )
+{
+    float Low = *Min / 32768.0f;
+    float High = *Max / 32768.0f;
+    float Sum = 0.0f;
+
+    for (UINT32 i = 0; i < Count; i++)
+    {
+        float Value = Samples[i];
+        Low = min( Low, Value );
+        High = max( High, Value );
+        Sum += Value * Value;
+    }
+
+    *Min = static_cast<int>( max( Low, -1.0f ) * 32768.0f );
+    *Max = static_cast<int>( min( High, 1.0f ) * 32767.0f );
+    *SumSquares += Sum * (32768.0 * 32768.0);
 }
 
 //
 //  ProcessScopeData()
 //
-//  Copies sample data to the buffer array and fires the event
+//  Decimates the samples into the scope frame and fires the event once the frame is full.  Each
+//  point of the frame is the minimum and maximum over all channels of an equal share of the
+//  visualized window, so the work per sample and the event rate don't depend on the device period.
 //
 HRESULT WASAPICapture::ProcessScopeData( BYTE* pData, DWORD cbBytes )
 {
     HRESULT hr = S_OK;
 
     // We don't have a valid pointer array, so return.  This could be the case if we aren't
-    // dealing with 16-bit audio
-    if (m_PlotData == nullptr)
+    // dealing with a supported format
+    if (m_ScopeFrames[0] == nullptr)
     {
         return S_FALSE;
     }
 
-    DWORD dwNumPoints = cbBytes / m_MixFormat->nChannels / (m_MixFormat->wBitsPerSample / 8);
-
-    // Read the 16-bit samples from channel 0
-    INT16 *pi16 = (INT16*)pData;
+    UINT32 FramesLeft = cbBytes / m_MixFormat->nBlockAlign;
 
-    for ( DWORD i = 0; m_cPlotDataFilled < m_cPlotDataMax && i < dwNumPoints; i++ )
+    while (FramesLeft > 0)
     {
-        m_PlotData[ m_cPlotDataFilled ] = *pi16;
-        pi16 += m_MixFormat->nChannels;
+        UINT32 Frames = min( FramesLeft, m_cScopeBucketFrames - m_cScopeBucketFilled );
+        UINT32 Samples = Frames * m_MixFormat->nChannels;
 
-        m_cPlotDataFilled++;
-    }
+        if (m_fScopeFloat)
+        {
+            ScanSamplesFloat( reinterpret_cast<float*>(pData), Samples, &m_ScopeMin, &m_ScopeMax, &m_ScopeSumSquares );
+        }
+        else if (m_MixFormat->wBitsPerSample == 16)
+        {
+            ScanSamples16( reinterpret_cast<INT16*>(pData), Samples, &m_ScopeMin, &m_ScopeMax, &m_ScopeSumSquares );
+        }
+        else if (m_MixFormat->wBitsPerSample == 24)
+        {
+            ScanSamples24( pData, Samples, &m_ScopeMin, &m_ScopeMax, &m_ScopeSumSquares );
+        }
+        else
+        {
+            ScanSamples32( reinterpret_cast<INT32*>(pData), Samples, &m_ScopeMin, &m_ScopeMax, &m_ScopeSumSquares );
+        }
 
-    // Send off the event and get ready for the next set of samples
-    if (m_cPlotDataFilled == m_cPlotDataMax)
-    {
-        ComPtr<IUnknown> spUnknown;
-        ComPtr<CAsyncState> spState = Make<CAsyncState>( m_PlotData, m_cPlotDataMax + 1 );
+        pData += Frames * m_MixFormat->nBlockAlign;
+        FramesLeft -= Frames;
+        m_cScopeBucketFilled += Frames;
 
-        hr = spState.As( &spUnknown );
-        if (SUCCEEDED( hr ))
+        if (m_cScopeBucketFilled < m_cScopeBucketFrames)
         {
-            MFPutWorkItem2( MFASYNC_CALLBACK_QUEUE_MULTITHREADED, 0, &m_xSendScopeData, spUnknown.Get() );
+            break;
         }
 
-        m_cPlotDataFilled = 0;
+        // The bucket is complete, store the point
+        Platform::Array<int, 1>^ Frame = m_ScopeFrames[ m_iScopeFrame ];
+        Frame[ m_cScopePoint * 2 ] = m_ScopeMin;
+        Frame[ m_cScopePoint * 2 + 1 ] = m_ScopeMax;
+
+        m_ScopeMin = INT_MAX;
+        m_ScopeMax = INT_MIN;
+        m_cScopeBucketFilled = 0;
+        m_cScopePoint++;
+
+        // Spread the remainder of the window over the buckets
+        m_cScopeBucketFrames = ((m_cScopePoint + 1) * m_cScopeWindowFrames) / SCOPE_POINTS - (m_cScopePoint * m_cScopeWindowFrames) / SCOPE_POINTS;
+
+        // Send off the event and get ready for the next frame
+        if (m_cScopePoint == SCOPE_POINTS)
+        {
+            float Rms = static_cast<float>( sqrt( m_ScopeSumSquares / (static_cast<double>( m_cScopeWindowFrames ) * m_MixFormat->nChannels) ) / 32768.0 );
+
+            ComPtr<IUnknown> spUnknown;
+            ComPtr<CAsyncState> spState = Make<CAsyncState>( Frame, SCOPE_POINTS * 2 + 1, Rms );
+
+            hr = spState.As( &spUnknown );
+            if (SUCCEEDED( hr ))
+            {
+                MFPutWorkItem2( MFASYNC_CALLBACK_QUEUE_MULTITHREADED, 0, &m_xSendScopeData, spUnknown.Get() );
+            }
+
+            m_iScopeFrame = (m_iScopeFrame + 1) % SCOPE_FRAME_BUFFERS;
+            m_cScopePoint = 0;
+            m_cScopeBucketFrames = m_cScopeWindowFrames / SCOPE_POINTS;
+            m_ScopeSumSquares = 0.0;
+        }
     }
 
     return hr;
@@ -814,7 +1113,7 @@ HRESULT WASAPICapture::OnSendScopeData( IMFAsyncResult* pResult )
     hr = pResult->GetState( reinterpret_cast<IUnknown**>(&pState) );
     if (SUCCEEDED( hr ))
     {
-        PlotDataReadyEvent::SendEvent( reinterpret_cast<Platform::Object^>(this), pState->m_Data , pState->m_Size );
+        PlotDataReadyEvent::SendEvent( reinterpret_cast<Platform::Object^>(this), pState->m_Data , pState->m_Size, pState->m_Rms );
     }
 
     SAFE_RELEASE( pState );
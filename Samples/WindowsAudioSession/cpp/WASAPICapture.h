@@ -20,13 +20,15 @@
 #include "MainPage.xaml.h"
 #include "DeviceState.h"
 #include "PlotData.h"
+#include "AudioRingBuffer.h"
 
 using namespace Microsoft::WRL;
 using namespace Windows::Media::Devices;
 using namespace Windows::Storage::Streams;
 
 #define AUDIO_FILE_NAME "WASAPIAudioCapture.wav"
-#define FLUSH_INTERVAL_SEC 3
+#define RING_BUFFER_SEC 2
+#define WRITE_CHUNK_FRAMES 16384
 
 
 #pragma once
@@ -56,6 +58,10 @@ namespace SDKSample
 
             DeviceStateChangedEvent^ GetDeviceStateEvent() { return m_DeviceStateChanged; };
 
+            // Capture statistics, valid once the capture has stopped
+            UINT32 GetOverrunCount() { return m_OverrunCount; };
+            UINT32 GetMaxCallbackMicroseconds();
+
             METHODASYNCCALLBACK( WASAPICapture, StartCapture, OnStartCapture );
             METHODASYNCCALLBACK( WASAPICapture, StopCapture, OnStopCapture );
             METHODASYNCCALLBACK( WASAPICapture, SampleReady, OnSampleReady );
@@ -77,6 +83,10 @@ namespace SDKSample
             HRESULT CreateWAVFile();
             HRESULT FixWAVHeader();
             HRESULT OnAudioSampleRequested( Platform::Boolean IsSilence = false );
+            HRESULT InitializeCaptureBuffer();
+            void StartWriter();
+            void WriterProc();
+            void WriteCapturedData( BOOL fFinal );
             HRESULT InitializeScopeData();
             HRESULT ProcessScopeData( BYTE* pData, DWORD cbBytes );
         
@@ -85,13 +95,24 @@ namespace SDKSample
             UINT32              m_BufferFrames;
             HANDLE              m_SampleReadyEvent;
             MFWORKITEM_KEY      m_SampleReadyKey;
-            CRITICAL_SECTION    m_CritSec;
             DWORD               m_dwQueueID;
 
             DWORD               m_cbHeaderSize;
-            DWORD               m_cbDataSize;
-            DWORD               m_cbFlushCounter;
-            BOOL                m_fWriting;
+            DWORD               m_cbDataSize;       // Bytes stored in the file, only updated by the writer
+            DWORD               m_cbCaptured;       // Bytes captured, only updated by the capture callback
+
+            // The capture callback copies the samples into m_CaptureBuffer and signals m_WriterEvent
+            // once a chunk is ready.  The writer drains the buffer into the file in chunks.
+            AudioRingBuffer         m_CaptureBuffer;
+            HANDLE                  m_WriterEvent;
+            Platform::Array<BYTE>^  m_WriteChunk;
+            UINT32                  m_cbWriteChunk;
+            BOOL                    m_fWriterStarted;
+            std::atomic<bool>       m_fStopWriter;
+
+            UINT32              m_OverrunCount;
+            LONGLONG            m_MaxCallbackTicks;
+            LARGE_INTEGER       m_QPCFrequency;
 
             IRandomAccessStream^     m_ContentStream;
             IOutputStream^           m_OutputStream;
@@ -107,9 +128,18 @@ namespace SDKSample
 
             DeviceStateChangedEvent^       m_DeviceStateChanged;
 
-            Platform::Array<int, 1>^    m_PlotData;
-            UINT32                      m_cPlotDataMax;
-            UINT32                      m_cPlotDataFilled;
+            // Scope decimation.  A frame covers MILLISECONDS_TO_VISUALIZE of audio split into
+            // SCOPE_POINTS buckets of m_cScopeBucketFrames frames.
+            Platform::Array<int, 1>^    m_ScopeFrames[ SCOPE_FRAME_BUFFERS ];
+            UINT32                      m_cScopeWindowFrames;
+            UINT32                      m_cScopeBucketFrames;
+            UINT32                      m_cScopeBucketFilled;
+            UINT32                      m_cScopePoint;
+            UINT32                      m_iScopeFrame;
+            BOOL                        m_fScopeFloat;
+            int                         m_ScopeMin;
+            int                         m_ScopeMax;
+            double                      m_ScopeSumSquares;  // Over the whole frame
 
             CAPTUREDEVICEPROPS          m_DeviceProps;
         };
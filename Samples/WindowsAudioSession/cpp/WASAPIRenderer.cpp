@@ -383,15 +383,14 @@ exit:
 HRESULT WASAPIRenderer::ConfigureSource()
 {
     HRESULT hr = S_OK;
-    UINT32 FramesPerPeriod = GetBufferFramesPerPeriod();
 
     if (m_DeviceProps.IsTonePlayback)
     {
-        // Generate the sine wave sample buffer
+        // Set up the sine wave oscillator, the samples are generated during playback
         m_ToneSource = new ToneSampleGenerator();
         if (m_ToneSource)
         {
-            hr = m_ToneSource->GenerateSampleBuffer( m_DeviceProps.Frequency, FramesPerPeriod, m_MixFormat );
+            hr = m_ToneSource->Initialize( m_DeviceProps.Frequency, m_MixFormat );
         }
         else
         {
@@ -403,7 +402,7 @@ HRESULT WASAPIRenderer::ConfigureSource()
         m_MFSource = new MFSampleGenerator();
         if (m_MFSource)
         {
-            hr = m_MFSource->Initialize( m_DeviceProps.ContentStream, FramesPerPeriod, m_MixFormat );
+            hr = m_MFSource->Initialize( m_DeviceProps.ContentStream, m_MixFormat );
         }
         else
         {
@@ -690,6 +689,30 @@ exit:
     return hr;
 }
 
+//
+//  GetSourceStatistics()
+//
+//  Reports how well the file source kept up with the endpoint.  Returns S_FALSE for tone playback.
+//
+HRESULT WASAPIRenderer::GetSourceStatistics( UINT32 *UnderrunCount, UINT32 *PoolMissCount, UINT32 *MinQueuedMilliseconds )
+{
+    if ( (nullptr == UnderrunCount) || (nullptr == PoolMissCount) || (nullptr == MinQueuedMilliseconds) )
+    {
+        return E_POINTER;
+    }
+
+    if (nullptr == m_MFSource)
+    {
+        return S_FALSE;
+    }
+
+    *UnderrunCount = m_MFSource->GetUnderrunCount();
+    *PoolMissCount = m_MFSource->GetPoolMissCount();
+    *MinQueuedMilliseconds = m_MFSource->GetMinQueuedMilliseconds();
+
+    return S_OK;
+}
+
 //
 //  GetToneSample()
 //
@@ -712,18 +735,18 @@ HRESULT WASAPIRenderer::GetToneSample( UINT32 FramesAvailable )
 
         StopPlaybackAsync();
     }
-    else if (m_ToneSource->GetBufferLength() <= ( FramesAvailable * m_MixFormat->nBlockAlign ))
+    else
     {
-        UINT32 ActualFramesToRead = m_ToneSource->GetBufferLength() / m_MixFormat->nBlockAlign;
-        UINT32 ActualBytesToRead = ActualFramesToRead * m_MixFormat->nBlockAlign;
+        UINT32 FramesWritten = 0;
 
-        hr = m_AudioRenderClient->GetBuffer( ActualFramesToRead, &Data );
+        // Synthesize the tone straight into the device buffer
+        hr = m_AudioRenderClient->GetBuffer( FramesAvailable, &Data );
         if (SUCCEEDED( hr ))
         {
-            hr = m_ToneSource->FillSampleBuffer( ActualBytesToRead, Data );
+            hr = m_ToneSource->FillSampleBuffer( FramesAvailable, Data, &FramesWritten );
             if (SUCCEEDED( hr ))
             {
-                hr = m_AudioRenderClient->ReleaseBuffer( ActualFramesToRead, 0 );
+                hr = m_AudioRenderClient->ReleaseBuffer( FramesWritten, 0 );
             }
         }
     }
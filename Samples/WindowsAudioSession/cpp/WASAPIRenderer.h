@@ -69,6 +69,7 @@ namespace SDKSample
 
             HRESULT SetVolumeOnSession( UINT32 volume );
             DeviceStateChangedEvent^ GetDeviceStateEvent() { return m_DeviceStateChanged; };
+            HRESULT GetSourceStatistics( UINT32 *UnderrunCount, UINT32 *PoolMissCount, UINT32 *MinQueuedMilliseconds );
 
             METHODASYNCCALLBACK( WASAPIRenderer, StartPlayback, OnStartPlayback );
             METHODASYNCCALLBACK( WASAPIRenderer, StopPlayback, OnStopPlayback );
@@ -41,12 +41,32 @@ void Scenario1::ReadXmlClick(Platform::Object^ sender, Windows::UI::Xaml::Routed
     Button^ b = safe_cast<Button^>(sender);
     StorageFolder^ installFolder = Windows::ApplicationModel::Package::Current->InstalledLocation;
 
+    // The element path is a list of element names separated by '/', starting at the root element.
+    // Only the nodes inside the elements it selects are printed.
+    std::vector<std::wstring> elementFilter;
+    std::wstring filterText(ElementFilter->Text->Data(), ElementFilter->Text->Length());
+    size_t start = 0;
+    while (start <= filterText.size())
+    {
+        size_t end = filterText.find(L'/', start);
+        if (end == std::wstring::npos)
+        {
+            end = filterText.size();
+        }
+        if (end > start)
+        {
+            elementFilter.push_back(filterText.substr(start, end - start));
+        }
+        start = end + 1;
+    }
+
     create_task(installFolder->GetFileAsync("Stocks.xml")).then([](StorageFile^ file)
     {
         return file->OpenAsync(FileAccessMode::Read);
-    }).then([this](IRandomAccessStream^ readStream)
+    }).then([this, elementFilter](IRandomAccessStream^ readStream)
     {
-        HRESULT hr = ReadXml(readStream);
+        HRESULT hr = ReadXml(readStream, elementFilter);
+        XmlTextbox->Text = ref new String(outputBuffer.c_str(), static_cast<unsigned int>(outputBuffer.size()));
         if (FAILED(hr))
         {
             XmlTextbox->Text = "Exception occured while reading the xml file, and the error code is " + hr.ToString();
@@ -55,13 +75,20 @@ void Scenario1::ReadXmlClick(Platform::Object^ sender, Windows::UI::Xaml::Routed
     });
 }
 
-HRESULT Scenario1::ReadXml(IRandomAccessStream^ randomAccessReadStream)
+HRESULT Scenario1::ReadXml(IRandomAccessStream^ randomAccessReadStream, const std::vector<std::wstring>& elementFilter)
 {
     HRESULT hr;
     ComPtr<IStream> readStream;
     ComPtr<IXmlReader> reader;
     XmlNodeType nodeType;
 
+    // The filter is evaluated while reading: depth is the number of open elements, and matchedDepth
+    // the number of names at the start of the filter that match the open elements.
+    size_t depth = 0;
+    size_t matchedDepth = 0;
+
+    outputBuffer.clear();
+
     ChkHr(::CreateStreamOverRandomAccessStream(randomAccessReadStream, IID_PPV_ARGS(&readStream)));
     ChkHr(::CreateXmlReader(IID_PPV_ARGS(&reader), nullptr));
     ChkHr(reader->SetProperty(XmlReaderProperty_DtdProcessing, DtdProcessing_Prohibit));
@@ -78,10 +105,43 @@ HRESULT Scenario1::ReadXml(IRandomAccessStream^ randomAccessReadStream)
         UINT localNameSize = 0;
         UINT valueSize = 0;
 
+        bool isEmptyElement = false;
+        if (nodeType == XmlNodeType_Element)
+        {
+            ChkHr(reader->GetLocalName(&localName, &localNameSize));
+            if ((matchedDepth == depth) && (depth < elementFilter.size()) &&
+                (elementFilter[depth].size() == localNameSize) && (wmemcmp(elementFilter[depth].c_str(), localName, localNameSize) == 0))
+            {
+                matchedDepth++;
+            }
+            isEmptyElement = !!reader->IsEmptyElement();
+            depth++;
+        }
+        else if (nodeType == XmlNodeType_EndElement)
+        {
+            depth--;
+        }
+
+        // Empty elements have no end element node, so they are closed as soon as they are printed.
+        bool isSelected = elementFilter.empty() || (matchedDepth == elementFilter.size());
+        if ((nodeType == XmlNodeType_EndElement) || isEmptyElement)
+        {
+            if (isEmptyElement)
+            {
+                depth--;
+            }
+            matchedDepth = (std::min)(matchedDepth, depth);
+        }
+
+        if (!isSelected)
+        {
+            continue;
+        }
+
         switch (nodeType)
         {
         case XmlNodeType_XmlDeclaration:
-            XmlTextbox->Text += L"XmlDeclaration\n";
+            outputBuffer += L"XmlDeclaration\n";
             ChkHr(ReadAttributes(reader.Get()));
             break;
 
@@ -90,22 +150,22 @@ HRESULT Scenario1::ReadXml(IRandomAccessStream^ randomAccessReadStream)
             ChkHr(reader->GetLocalName(&localName, &localNameSize));
             if (prefixSize > 0)
             {
-                XmlTextbox->Text += L"Element: ";
+                outputBuffer += L"Element: ";
                 ChkHr(ConcatToOutput(prefix, prefixSize));
                 ChkHr(ConcatToOutput(localName, localNameSize));
-                XmlTextbox->Text += L"\n";
+                outputBuffer += L"\n";
             }
             else
             {
-                XmlTextbox->Text += L"Element: ";
+                outputBuffer += L"Element: ";
                 ChkHr(ConcatToOutput(localName, localNameSize));
-                XmlTextbox->Text += L"\n";
+                outputBuffer += L"\n";
             }
             ChkHr(ReadAttributes(reader.Get()));
 
-            if (reader->IsEmptyElement())
+            if (isEmptyElement)
             {
-                XmlTextbox->Text += L" (empty)";
+                outputBuffer += L" (empty)";
             }
             break;
 
@@ -114,60 +174,60 @@ HRESULT Scenario1::ReadXml(IRandomAccessStream^ randomAccessReadStream)
             ChkHr(reader->GetLocalName(&localName, &localNameSize));
             if (prefixSize > 0)
             {
-                XmlTextbox->Text += L"End Element: ";
+                outputBuffer += L"End Element: ";
                 ChkHr(ConcatToOutput(prefix, prefixSize));
-                XmlTextbox->Text += L":";
+                outputBuffer += L":";
                 ChkHr(ConcatToOutput(localName, localNameSize));
-                XmlTextbox->Text += L"\n";
+                outputBuffer += L"\n";
             }
             else
             {
-                XmlTextbox->Text += L"End Element: ";
+                outputBuffer += L"End Element: ";
                 ChkHr(ConcatToOutput(localName, localNameSize));
-                XmlTextbox->Text += L"\n";
+                outputBuffer += L"\n";
             }
             break;
 
         case XmlNodeType_Text:
             ChkHr(reader->GetValue(&value, &valueSize));
-            XmlTextbox->Text += L"Text: >";
+            outputBuffer += L"Text: >";
             ChkHr(ConcatToOutput(value, valueSize));
-            XmlTextbox->Text += L"<\n";
+            outputBuffer += L"<\n";
             break;
 
         case XmlNodeType_CDATA:
             ChkHr(reader->GetValue(&value, &valueSize));
-            XmlTextbox->Text += L"CDATA: ";
-            XmlTextbox->Text += ref new String(value, valueSize);
-            XmlTextbox->Text += L"\n";
+            outputBuffer += L"CDATA: ";
+            ChkHr(ConcatToOutput(value, valueSize));
+            outputBuffer += L"\n";
             break;
 
         case XmlNodeType_ProcessingInstruction:
             ChkHr(reader->GetLocalName(&localName, &localNameSize));
             ChkHr(reader->GetValue(&value, &valueSize));
-            XmlTextbox->Text += L"Processing Instruction name:";
+            outputBuffer += L"Processing Instruction name:";
             ChkHr(ConcatToOutput(localName, localNameSize));
-            XmlTextbox->Text += L"value:";
+            outputBuffer += L"value:";
             ChkHr(ConcatToOutput(value, valueSize));
-            XmlTextbox->Text += L"\n";
+            outputBuffer += L"\n";
             break;
 
         case XmlNodeType_Comment:
             ChkHr(reader->GetValue(&value, &valueSize));
-            XmlTextbox->Text += L"Comment: ";
+            outputBuffer += L"Comment: ";
             ChkHr(ConcatToOutput(value, valueSize));
-            XmlTextbox->Text += L"\n";
+            outputBuffer += L"\n";
             break;
 
         case XmlNodeType_DocumentType:
-            XmlTextbox->Text += L"DOCTYPE is not printed\n";
+            outputBuffer += L"DOCTYPE is not printed\n";
             break;
 
         case XmlNodeType_Whitespace:
             ChkHr(reader->GetValue(&value, &valueSize));
-            XmlTextbox->Text += L"WhiteSpace: ";
+            outputBuffer += L"WhiteSpace: ";
             ChkHr(ConcatToOutput(value, valueSize));
-            XmlTextbox->Text += L"\n";
+            outputBuffer += L"\n";
             break;
 
         default:
@@ -201,21 +261,21 @@ HRESULT Scenario1::ReadAttributes(IXmlReader* reader)
 
             if (prefixSize > 0)
             {
-                XmlTextbox->Text += L"Attr: ";
+                outputBuffer += L"Attr: ";
                 ChkHr(ConcatToOutput(prefix, prefixSize));
-                XmlTextbox->Text += L":";
+                outputBuffer += L":";
                 ChkHr(ConcatToOutput(localName, localNameSize));
-                XmlTextbox->Text += L"=\"";
+                outputBuffer += L"=\"";
                 ChkHr(ConcatToOutput(value, valueSize));
-                XmlTextbox->Text += L"\"\n";
+                outputBuffer += L"\"\n";
             }
             else
             {
-                XmlTextbox->Text += L"Attr: ";
+                outputBuffer += L"Attr: ";
                 ChkHr(ConcatToOutput(localName, localNameSize));
-                XmlTextbox->Text += L"=\"";
+                outputBuffer += L"=\"";
                 ChkHr(ConcatToOutput(value, valueSize));
-                XmlTextbox->Text += L"\"\n";
+                outputBuffer += L"\"\n";
             }
         }
 
@@ -232,11 +292,11 @@ HRESULT Scenario1::ConcatToOutput(PCWSTR str, UINT strLen)
 
     try
     {
-        XmlTextbox->Text += ref new String(str, strLen);
+        outputBuffer.append(str, strLen);
     }
-    catch (Platform::Exception^ e)
+    catch (std::bad_alloc&)
     {
-        hr = e->HResult;
+        hr = E_OUTOFMEMORY;
     }
 
     return hr;
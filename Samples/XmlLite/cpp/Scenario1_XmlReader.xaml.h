@@ -31,7 +31,11 @@ namespace SDKTemplate
             MainPage^ rootPage;
             void ReadXmlClick(Platform::Object^ sender, Windows::UI::Xaml::RoutedEventArgs^ e);
 
-            HRESULT ReadXml(Windows::Storage::Streams::IRandomAccessStream^ readStream);
+            // The output is built here and copied to the text box once the whole document has been read.
+            // The buffer is kept between runs so that its storage is reused.
+            std::wstring outputBuffer;
+
+            HRESULT ReadXml(Windows::Storage::Streams::IRandomAccessStream^ readStream, const std::vector<std::wstring>& elementFilter);
             HRESULT ReadAttributes(IXmlReader* reader);
             HRESULT ConcatToOutput(PCWSTR str, UINT strLen);
         };
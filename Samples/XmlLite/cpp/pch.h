@@ -7,6 +7,8 @@
 #include <collection.h>
 #include <ppltasks.h>
 #include <shcore.h>
+#include <string>
+#include <vector>
 #include <wrl.h>
 #include <xmllite.h>
 
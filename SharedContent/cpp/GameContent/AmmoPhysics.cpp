@@ -0,0 +1,232 @@
+//********************************************************* 
+// 
+// Copyright (c) Microsoft. All rights reserved. 
+// This code is licensed under the MIT License (MIT). 
+// THIS CODE IS PROVIDED *AS IS* WITHOUT WARRANTY OF 
+// ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING ANY 
+// IMPLIED WARRANTIES OF FITNESS FOR A PARTICULAR 
+// PURPOSE, MERCHANTABILITY, OR NON-INFRINGEMENT. 
+// 
+//*********************************************************
+
+#include "pch.h"
+#include "AmmoPhysics.h"
+#include "GameConstants.h"
+#include <algorithm>
+
+using namespace DirectX;
+
+namespace
+{
+    // Moves the lanes selected by hit back to the limit, reverses their velocity and
+    // records the impact speed.
+    __forceinline XMVECTOR Bounce(
+        XMVECTOR hit,
+        XMVECTOR limit,
+        _Inout_ XMVECTOR *position,
+        _Inout_ XMVECTOR *velocity,
+        _Inout_ XMVECTOR *impact
+        )
+    {
+        *position = XMVectorSelect(*position, limit, hit);
+        *impact = XMVectorMax(*impact, XMVectorSelect(XMVectorZero(), XMVectorNegate(*velocity), hit));
+        *velocity = XMVectorSelect(*velocity, *velocity * -GameConstants::Physics::GroundRestitution, hit);
+        return hit;
+    }
+
+    __forceinline XMVECTOR LoadLanes(const std::vector<float>& values, uint32 index)
+    {
+        return XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&values[index]));
+    }
+
+    __forceinline void StoreLanes(std::vector<float>& values, uint32 index, XMVECTOR lanes)
+    {
+        XMStoreFloat4(reinterpret_cast<XMFLOAT4*>(&values[index]), lanes);
+    }
+}
+
+//----------------------------------------------------------------------
+
+AmmoPhysics::AmmoPhysics(uint32 capacity)
+{
+    uint32 paddedCapacity = (capacity + 3) & ~3;
+
+    m_positionX.resize(paddedCapacity, 0.0f);
+    m_positionY.resize(paddedCapacity, 0.0f);
+    m_positionZ.resize(paddedCapacity, 0.0f);
+    m_velocityX.resize(paddedCapacity, 0.0f);
+    m_velocityY.resize(paddedCapacity, 0.0f);
+    m_velocityZ.resize(paddedCapacity, 0.0f);
+    m_ground.resize(paddedCapacity, 0);
+    m_impact.resize(paddedCapacity, 0.0f);
+    m_contactImpact.resize(paddedCapacity, 0.0f);
+}
+
+//----------------------------------------------------------------------
+
+void AmmoPhysics::Integrate(
+    uint32 count,
+    float timeStep,
+    XMFLOAT3 minBound,
+    XMFLOAT3 maxBound,
+    float radius
+    )
+{
+    const XMVECTOR zero = XMVectorZero();
+    const XMVECTOR step = XMVectorReplicate(timeStep);
+    const XMVECTOR drag = XMVectorReplicate(1.0f - 0.1f * timeStep);
+    const XMVECTOR gravityStep = XMVectorReplicate(GameConstants::Physics::Gravity * timeStep);
+    const XMVECTOR friction = XMVectorReplicate(GameConstants::Physics::Friction);
+    const XMVECTOR floorLimit = XMVectorReplicate(minBound.y + radius);
+    const XMVECTOR ceilingLimit = XMVectorReplicate(maxBound.y - radius);
+    const XMVECTOR minLimitX = XMVectorReplicate(minBound.x + radius);
+    const XMVECTOR maxLimitX = XMVectorReplicate(maxBound.x - radius);
+    const XMVECTOR minLimitZ = XMVectorReplicate(minBound.z + radius);
+    const XMVECTOR maxLimitZ = XMVectorReplicate(maxBound.z - radius);
+
+    // The ammo is processed in groups of four.  The entries past count in the last group are
+    // updated as well; they belong to ammo that is not in play and get reset when it is fired.
+    for (uint32 i = 0; i < count; i += 4)
+    {
+        XMVECTOR positionX = LoadLanes(m_positionX, i);
+        XMVECTOR positionY = LoadLanes(m_positionY, i);
+        XMVECTOR positionZ = LoadLanes(m_positionZ, i);
+        XMVECTOR velocityX = LoadLanes(m_velocityX, i);
+        XMVECTOR velocityY = LoadLanes(m_velocityY, i);
+        XMVECTOR velocityZ = LoadLanes(m_velocityZ, i);
+        XMVECTOR ground = XMLoadInt4(&m_ground[i]);
+        XMVECTOR impact = zero;
+
+        // Update the position of the ammo with the velocity from the previous step.
+        positionX = XMVectorMultiplyAdd(velocityX, step, positionX);
+        positionY = XMVectorMultiplyAdd(velocityY, step, positionY);
+        positionZ = XMVectorMultiplyAdd(velocityZ, step, positionZ);
+
+        velocityX = velocityX * drag;
+        velocityZ = velocityZ * drag;
+
+        // Apply gravity if the ammo is not already resting on the ground.
+        velocityY = XMVectorSelect(velocityY - gravityStep, velocityY, ground);
+
+        // Ammo that hit the ground bounces back up.  The X and Z velocity components of the
+        // ammo that hit the ground or are rolling on it are reduced because of friction.
+        XMVECTOR hitFloor = XMVectorAndCInt(XMVectorLess(positionY, floorLimit), ground);
+        Bounce(hitFloor, floorLimit, &positionY, &velocityY, &impact);
+
+        XMVECTOR onFloor = XMVectorOrInt(hitFloor, ground);
+        velocityX = XMVectorSelect(velocityX, velocityX * friction, onFloor);
+        velocityZ = XMVectorSelect(velocityZ, velocityZ * friction, onFloor);
+
+        // Ammo that hit the ceiling bounces back down, also with friction.
+        XMVECTOR hitCeiling = Bounce(XMVectorGreater(positionY, ceilingLimit), ceilingLimit, &positionY, &velocityY, &impact);
+        velocityX = XMVectorSelect(velocityX, velocityX * friction, hitCeiling);
+        velocityZ = XMVectorSelect(velocityZ, velocityZ * friction, hitCeiling);
+
+        // When the energy of the ammo is below the resting threshold, it is laying on the ground.
+        XMVECTOR energy = XMVectorMultiplyAdd(
+            XMVectorReplicate(GameConstants::Physics::Gravity),
+            positionY - floorLimit,
+            XMVectorReplicate(0.5f) * velocityY * velocityY
+            );
+        XMVECTOR resting = XMVectorLess(energy, XMVectorReplicate(GameConstants::Physics::RestThreshold));
+        positionY = XMVectorSelect(positionY, floorLimit, resting);
+        velocityY = XMVectorSelect(velocityY, zero, resting);
+        ground = XMVectorOrInt(ground, resting);
+
+        // Bounce off the walls.
+        Bounce(XMVectorLess(positionZ, minLimitZ), minLimitZ, &positionZ, &velocityZ, &impact);
+        Bounce(XMVectorGreater(positionZ, maxLimitZ), maxLimitZ, &positionZ, &velocityZ, &impact);
+        Bounce(XMVectorLess(positionX, minLimitX), minLimitX, &positionX, &velocityX, &impact);
+        Bounce(XMVectorGreater(positionX, maxLimitX), maxLimitX, &positionX, &velocityX, &impact);
+
+        StoreLanes(m_positionX, i, positionX);
+        StoreLanes(m_positionY, i, positionY);
+        StoreLanes(m_positionZ, i, positionZ);
+        StoreLanes(m_velocityX, i, velocityX);
+        StoreLanes(m_velocityY, i, velocityY);
+        StoreLanes(m_velocityZ, i, velocityZ);
+        XMStoreInt4(&m_ground[i], ground);
+        StoreLanes(m_impact, i, impact);
+    }
+}
+
+//----------------------------------------------------------------------
+
+void AmmoPhysics::Collide(
+    uint32 count,
+    _In_ const std::vector<AmmoPair>& pairs,
+    float ammoSize
+    )
+{
+    std::fill(m_contactImpact.begin(), m_contactImpact.begin() + count, 0.0f);
+
+    for (uint32 p = 0; p < pairs.size(); p++)
+    {
+        CollidePair(pairs[p], ammoSize);
+    }
+}
+
+//----------------------------------------------------------------------
+
+void AmmoPhysics::CollidePair(AmmoPair pair, float ammoSize)
+{
+    uint32 one = pair.one;
+    uint32 two = pair.two;
+
+    // Check collision between instances One and Two.
+    // OneToTwo is the vector between the centers of the two ammo that are being checked.
+    XMVECTOR oneToTwo;
+    oneToTwo = VectorPosition(two) - VectorPosition(one);
+    float distanceSquared;
+    distanceSquared = XMVectorGetX(
+        XMVector3LengthSq(oneToTwo)
+        );
+    if (distanceSquared < (ammoSize * ammoSize))
+    {
+        // The two ammo are intersecting.
+        oneToTwo = XMVector3Normalize(oneToTwo);
+
+        // Check if the two instances are already moving away from each other.
+        // If so, skip collision.  This can happen when a lot of instances are
+        // bunched up next to each other.
+        float impact;
+        impact = XMVectorGetX(
+            XMVector3Dot(oneToTwo, VectorVelocity(one)) -
+            XMVector3Dot(oneToTwo, VectorVelocity(two))
+            );
+        if (impact > 0.0f)
+        {
+            // Compute the normal and tangential components of one's velocity.
+            XMVECTOR velocityOne = (1 - GameConstants::Physics::BounceLost) * VectorVelocity(one);
+            XMVECTOR velocityOneNormal = XMVector3Dot(oneToTwo, velocityOne) * oneToTwo;
+            XMVECTOR velocityOneTangent = velocityOne - velocityOneNormal;
+            // Compute the normal and tangential components of two's velocity.
+            XMVECTOR velocityTwo = (1 - GameConstants::Physics::BounceLost) * VectorVelocity(two);
+            XMVECTOR velocityTwoNormal = XMVector3Dot(oneToTwo, velocityTwo) * oneToTwo;
+            XMVECTOR velocityTwoTangent = velocityTwo - velocityTwoNormal;
+
+            // Compute the post-collision velocities.
+            Velocity(one, velocityOneTangent - velocityOneNormal * (1 - GameConstants::Physics::BounceTransfer) +
+                velocityTwoNormal * GameConstants::Physics::BounceTransfer
+                );
+            Velocity(two, velocityTwoTangent - velocityTwoNormal * (1 - GameConstants::Physics::BounceTransfer) +
+                velocityOneNormal * GameConstants::Physics::BounceTransfer
+                );
+
+            // Fix the positions so that the two balls are exactly ammoSize apart.
+            float distanceToMove = (ammoSize - sqrtf(distanceSquared)) * 0.5f;
+            Position(one, VectorPosition(one) - (oneToTwo * distanceToMove));
+            Position(two, VectorPosition(two) + (oneToTwo * distanceToMove));
+
+            // Flag the two instances so that they are not laying on ground.
+            OnGround(one, false);
+            OnGround(two, false);
+
+            // Remember the impact so the caller can play the sounds.
+            m_contactImpact[one] = max(m_contactImpact[one], impact);
+            m_contactImpact[two] = max(m_contactImpact[two], impact);
+        }
+    }
+}
+
+//----------------------------------------------------------------------
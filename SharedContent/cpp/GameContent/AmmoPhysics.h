@@ -0,0 +1,149 @@
+//********************************************************* 
+// 
+// Copyright (c) Microsoft. All rights reserved. 
+// This code is licensed under the MIT License (MIT). 
+// THIS CODE IS PROVIDED *AS IS* WITHOUT WARRANTY OF 
+// ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING ANY 
+// IMPLIED WARRANTIES OF FITNESS FOR A PARTICULAR 
+// PURPOSE, MERCHANTABILITY, OR NON-INFRINGEMENT. 
+// 
+//*********************************************************
+
+#pragma once
+
+// AmmoPhysics:
+// This class holds the physics state of all the ammo in the game.  Each property is kept in
+// its own array (structure of arrays), so the motion of the ammo can be computed four at a
+// time with the DirectXMath vector functions.  The Sphere objects in Simple3DGame::m_ammo
+// only mirror the ammo positions for rendering and for saving the game state.
+//
+// Integrate moves the ammo by one time step: it applies the velocity, air drag, gravity and
+// ground friction and bounces the ammo off the floor, ceiling and walls of the world.  The
+// speed of the strongest impact of each ammo during the step is available from Impact, so
+// the caller can play the hit sounds.
+//
+// Collide resolves the contacts between the candidate pairs of ammo found by BroadPhase, in
+// the order they are listed.  The strongest impact of each ammo is available from
+// ContactImpact.
+
+struct AmmoPair
+{
+    uint32 one;
+    uint32 two;
+};
+
+ref class AmmoPhysics
+{
+internal:
+    AmmoPhysics(uint32 capacity);
+
+    void Integrate(
+        uint32 count,
+        float timeStep,
+        DirectX::XMFLOAT3 minBound,
+        DirectX::XMFLOAT3 maxBound,
+        float radius
+        );
+
+    void Collide(
+        uint32 count,
+        _In_ const std::vector<AmmoPair>& pairs,
+        float ammoSize
+        );
+
+    void Position(uint32 index, DirectX::XMFLOAT3 position);
+    void Position(uint32 index, DirectX::XMVECTOR position);
+    void Velocity(uint32 index, DirectX::XMFLOAT3 velocity);
+    void Velocity(uint32 index, DirectX::XMVECTOR velocity);
+    void OnGround(uint32 index, bool ground);
+    DirectX::XMFLOAT3 Position(uint32 index);
+    DirectX::XMVECTOR VectorPosition(uint32 index);
+    DirectX::XMFLOAT3 Velocity(uint32 index);
+    DirectX::XMVECTOR VectorVelocity(uint32 index);
+    bool OnGround(uint32 index);
+    float Impact(uint32 index);
+    float ContactImpact(uint32 index);
+
+private:
+    void CollidePair(AmmoPair pair, float ammoSize);
+
+    // The arrays are padded to a multiple of four entries.
+    std::vector<float>      m_positionX;
+    std::vector<float>      m_positionY;
+    std::vector<float>      m_positionZ;
+    std::vector<float>      m_velocityX;
+    std::vector<float>      m_velocityY;
+    std::vector<float>      m_velocityZ;
+    std::vector<uint32>     m_ground;       // 0xFFFFFFFF when the ammo is resting on the ground, 0 otherwise.
+    std::vector<float>      m_impact;
+    std::vector<float>      m_contactImpact;    // Strongest impact with other ammo during Collide.
+};
+
+
+__forceinline void AmmoPhysics::Position(uint32 index, DirectX::XMFLOAT3 position)
+{
+    m_positionX[index] = position.x;
+    m_positionY[index] = position.y;
+    m_positionZ[index] = position.z;
+}
+
+__forceinline void AmmoPhysics::Position(uint32 index, DirectX::XMVECTOR position)
+{
+    m_positionX[index] = DirectX::XMVectorGetX(position);
+    m_positionY[index] = DirectX::XMVectorGetY(position);
+    m_positionZ[index] = DirectX::XMVectorGetZ(position);
+}
+
+__forceinline void AmmoPhysics::Velocity(uint32 index, DirectX::XMFLOAT3 velocity)
+{
+    m_velocityX[index] = velocity.x;
+    m_velocityY[index] = velocity.y;
+    m_velocityZ[index] = velocity.z;
+}
+
+__forceinline void AmmoPhysics::Velocity(uint32 index, DirectX::XMVECTOR velocity)
+{
+    m_velocityX[index] = DirectX::XMVectorGetX(velocity);
+    m_velocityY[index] = DirectX::XMVectorGetY(velocity);
+    m_velocityZ[index] = DirectX::XMVectorGetZ(velocity);
+}
+
+__forceinline void AmmoPhysics::OnGround(uint32 index, bool ground)
+{
+    m_ground[index] = ground ? 0xFFFFFFFF : 0;
+}
+
+__forceinline DirectX::XMFLOAT3 AmmoPhysics::Position(uint32 index)
+{
+    return DirectX::XMFLOAT3(m_positionX[index], m_positionY[index], m_positionZ[index]);
+}
+
+__forceinline DirectX::XMVECTOR AmmoPhysics::VectorPosition(uint32 index)
+{
+    return DirectX::XMVectorSet(m_positionX[index], m_positionY[index], m_positionZ[index], 0.0f);
+}
+
+__forceinline DirectX::XMFLOAT3 AmmoPhysics::Velocity(uint32 index)
+{
+    return DirectX::XMFLOAT3(m_velocityX[index], m_velocityY[index], m_velocityZ[index]);
+}
+
+__forceinline DirectX::XMVECTOR AmmoPhysics::VectorVelocity(uint32 index)
+{
+    return DirectX::XMVectorSet(m_velocityX[index], m_velocityY[index], m_velocityZ[index], 0.0f);
+}
+
+__forceinline bool AmmoPhysics::OnGround(uint32 index)
+{
+    return m_ground[index] != 0;
+}
+
+__forceinline float AmmoPhysics::Impact(uint32 index)
+{
+    return m_impact[index];
+}
+
+__forceinline float AmmoPhysics::ContactImpact(uint32 index)
+{
+    return m_contactImpact[index];
+}
@@ -0,0 +1,229 @@
+//********************************************************* 
+// 
+// Copyright (c) Microsoft. All rights reserved. 
+// This code is licensed under the MIT License (MIT). 
+// THIS CODE IS PROVIDED *AS IS* WITHOUT WARRANTY OF 
+// ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING ANY 
+// IMPLIED WARRANTIES OF FITNESS FOR A PARTICULAR 
+// PURPOSE, MERCHANTABILITY, OR NON-INFRINGEMENT. 
+// 
+//*********************************************************
+
+#include "pch.h"
+#include "BroadPhase.h"
+#include <algorithm>
+
+using namespace DirectX;
+
+//----------------------------------------------------------------------
+
+BroadPhase::BroadPhase():
+    m_maxObjectWidth(0.0f),
+    m_cellSize(1.0f),
+    m_bucketMask(0)
+{
+}
+
+//----------------------------------------------------------------------
+
+void BroadPhase::UpdateObjects(
+    _In_ const std::vector<GameObject^>& objects,
+    _In_opt_ GameObject^ movingObject
+    )
+{
+    m_objectBounds.clear();
+    m_unboundedObjects.clear();
+    m_maxObjectWidth = 0.0f;
+
+    for (uint32 i = 0; i < objects.size(); i++)
+    {
+        if (!objects[i]->Active())
+        {
+            continue;
+        }
+
+        ObjectBounds bounds;
+        bounds.index = i;
+
+        if (objects[i] == movingObject || !objects[i]->BoundingBox(&bounds.minPoint, &bounds.maxPoint))
+        {
+            m_unboundedObjects.push_back(i);
+        }
+        else
+        {
+            m_maxObjectWidth = max(m_maxObjectWidth, bounds.maxPoint.x - bounds.minPoint.x);
+            m_objectBounds.push_back(bounds);
+        }
+    }
+
+    std::sort(
+        m_objectBounds.begin(),
+        m_objectBounds.end(),
+        [](const ObjectBounds& a, const ObjectBounds& b) { return a.minPoint.x < b.minPoint.x; }
+        );
+}
+
+//----------------------------------------------------------------------
+
+void BroadPhase::ObjectCandidates(
+    XMFLOAT3 point,
+    float radius,
+    _Out_ std::vector<uint32>* candidates
+    )
+{
+    candidates->clear();
+
+    // Face::IsTouching accepts points up to the radius away from the plane and up to the
+    // radius outside the edges, so the query box is grown by twice the radius.
+    float extent = radius * 2.0f;
+    XMFLOAT3 minPoint(point.x - extent, point.y - extent, point.z - extent);
+    XMFLOAT3 maxPoint(point.x + extent, point.y + extent, point.z + extent);
+
+    // No box starting left of this can reach the query box.
+    float minStart = minPoint.x - m_maxObjectWidth;
+    auto it = std::lower_bound(
+        m_objectBounds.begin(),
+        m_objectBounds.end(),
+        minStart,
+        [](const ObjectBounds& bounds, float x) { return bounds.minPoint.x < x; }
+        );
+
+    for (; it != m_objectBounds.end() && it->minPoint.x <= maxPoint.x; ++it)
+    {
+        if (it->maxPoint.x >= minPoint.x &&
+            it->minPoint.y <= maxPoint.y && it->maxPoint.y >= minPoint.y &&
+            it->minPoint.z <= maxPoint.z && it->maxPoint.z >= minPoint.z)
+        {
+            candidates->push_back(it->index);
+        }
+    }
+
+    candidates->insert(candidates->end(), m_unboundedObjects.begin(), m_unboundedObjects.end());
+    std::sort(candidates->begin(), candidates->end());
+}
+
+//----------------------------------------------------------------------
+
+void BroadPhase::UpdateAmmo(
+    _In_ AmmoPhysics^ ammo,
+    uint32 ammoCount,
+    float ammoSize
+    )
+{
+    // Keep the hash table at most half full.
+    uint32 bucketCount = 64;
+    while (bucketCount < ammoCount * 2)
+    {
+        bucketCount <<= 1;
+    }
+
+    m_cellSize = ammoSize;
+    m_bucketMask = bucketCount - 1;
+    m_ammoCells.resize(ammoCount);
+    m_bucketEntries.resize(ammoCount);
+    m_bucketStart.assign(bucketCount + 1, 0);
+
+    // Count the ammo in each bucket.
+    float scale = 1.0f / m_cellSize;
+    for (uint32 i = 0; i < ammoCount; i++)
+    {
+        XMFLOAT3 position = ammo->Position(i);
+        Cell& cell = m_ammoCells[i];
+        cell.x = static_cast<int>(floorf(position.x * scale));
+        cell.y = static_cast<int>(floorf(position.y * scale));
+        cell.z = static_cast<int>(floorf(position.z * scale));
+
+        m_bucketStart[Bucket(cell.x, cell.y, cell.z) + 1]++;
+    }
+
+    for (uint32 b = 0; b < bucketCount; b++)
+    {
+        m_bucketStart[b + 1] += m_bucketStart[b];
+    }
+
+    // Place the ammo in bucket order.  This moves each bucket start to the start of the
+    // following bucket, so shift them back afterwards.
+    for (uint32 i = 0; i < ammoCount; i++)
+    {
+        const Cell& cell = m_ammoCells[i];
+        m_bucketEntries[m_bucketStart[Bucket(cell.x, cell.y, cell.z)]++] = i;
+    }
+
+    for (uint32 b = bucketCount; b > 0; b--)
+    {
+        m_bucketStart[b] = m_bucketStart[b - 1];
+    }
+    m_bucketStart[0] = 0;
+
+    // Find the candidate pairs.  They come out in increasing (one, two) order, which is the
+    // order the collisions are resolved in.
+    m_ammoPairs.clear();
+    for (uint32 one = 0; one < ammoCount; one++)
+    {
+        AmmoCandidates(one, &m_candidates);
+        for (uint32 c = 0; c < m_candidates.size(); c++)
+        {
+            AmmoPair pair = { one, m_candidates[c] };
+            m_ammoPairs.push_back(pair);
+        }
+    }
+}
+
+//----------------------------------------------------------------------
+
+void BroadPhase::AmmoCandidates(
+    uint32 one,
+    _Out_ std::vector<uint32>* candidates
+    )
+{
+    candidates->clear();
+
+    const Cell cell = m_ammoCells[one];
+    uint32 visited[27];
+    uint32 visitedCount = 0;
+
+    for (int z = cell.z - 1; z <= cell.z + 1; z++)
+    {
+        for (int y = cell.y - 1; y <= cell.y + 1; y++)
+        {
+            for (int x = cell.x - 1; x <= cell.x + 1; x++)
+            {
+                // Several of the neighboring cells may share a bucket.
+                uint32 bucket = Bucket(x, y, z);
+                if (std::find(visited, visited + visitedCount, bucket) != visited + visitedCount)
+                {
+                    continue;
+                }
+                visited[visitedCount++] = bucket;
+
+                for (uint32 e = m_bucketStart[bucket]; e < m_bucketStart[bucket + 1]; e++)
+                {
+                    uint32 two = m_bucketEntries[e];
+                    const Cell& other = m_ammoCells[two];
+
+                    // Skip ammo from far away cells that happen to share the bucket.
+                    if (two > one &&
+                        abs(other.x - cell.x) <= 1 &&
+                        abs(other.y - cell.y) <= 1 &&
+                        abs(other.z - cell.z) <= 1)
+                    {
+                        candidates->push_back(two);
+                    }
+                }
+            }
+        }
+    }
+
+    std::sort(candidates->begin(), candidates->end());
+}
+
+//----------------------------------------------------------------------
+
+uint32 BroadPhase::Bucket(int x, int y, int z)
+{
+    return ((static_cast<uint32>(x) * 73856093) ^
+            (static_cast<uint32>(y) * 19349663) ^
+            (static_cast<uint32>(z) * 83492791)) & m_bucketMask;
+}
+
+//----------------------------------------------------------------------
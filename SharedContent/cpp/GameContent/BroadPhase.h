@@ -0,0 +1,100 @@
+//********************************************************* 
+// 
+// Copyright (c) Microsoft. All rights reserved. 
+// This code is licensed under the MIT License (MIT). 
+// THIS CODE IS PROVIDED *AS IS* WITHOUT WARRANTY OF 
+// ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING ANY 
+// IMPLIED WARRANTIES OF FITNESS FOR A PARTICULAR 
+// PURPOSE, MERCHANTABILITY, OR NON-INFRINGEMENT. 
+// 
+//*********************************************************
+
+#pragma once
+
+// BroadPhase:
+// This class finds the pairs of objects that may be in contact, so the game physics only
+// calls the exact (and more expensive) intersection tests for those pairs.
+//     Ammo - the ammo positions are sorted into a uniform grid with cells as large as the
+//         ammo diameter.  Two ammo instances can only be touching if they are in the same or
+//         in neighboring cells.
+//     Objects - the bounding boxes of the active objects are sorted along the X axis
+//         (sweep and prune).  Objects without a bounding box and the moving object (the
+//         player) are returned for every query.
+// The candidate lists are returned in increasing index order, so the collisions are resolved
+// in the same order as when testing every pair.
+
+#include "GameObject.h"
+#include "AmmoPhysics.h"
+
+ref class BroadPhase
+{
+internal:
+    BroadPhase();
+
+    // Rebuilds the object bounds.  Call when objects moved or were activated.  The moving
+    // object is expected to change its position before the next call.
+    void UpdateObjects(
+        _In_ const std::vector<GameObject^>& objects,
+        _In_opt_ GameObject^ movingObject
+        );
+
+    // Rebuilds the ammo grid and the candidate pairs from the current positions of the
+    // first ammoCount ammo.
+    void UpdateAmmo(
+        _In_ AmmoPhysics^ ammo,
+        uint32 ammoCount,
+        float ammoSize
+        );
+
+    // The candidate pairs, in increasing order of the first and then the second index.
+    const std::vector<AmmoPair>& AmmoPairs();
+
+    // Indices of the objects that may be touching the sphere at point.
+    void ObjectCandidates(
+        DirectX::XMFLOAT3 point,
+        float radius,
+        _Out_ std::vector<uint32>* candidates
+        );
+
+private:
+    struct ObjectBounds
+    {
+        DirectX::XMFLOAT3   minPoint;
+        DirectX::XMFLOAT3   maxPoint;
+        uint32              index;
+    };
+
+    struct Cell
+    {
+        int x;
+        int y;
+        int z;
+    };
+
+    uint32 Bucket(int x, int y, int z);
+
+    // Indices greater than 'one' of the ammo that may be within ammoSize of ammo 'one'.
+    void AmmoCandidates(
+        uint32 one,
+        _Out_ std::vector<uint32>* candidates
+        );
+
+    // Objects
+    std::vector<ObjectBounds>   m_objectBounds;     // Sorted by minPoint.x.
+    std::vector<uint32>         m_unboundedObjects;
+    float                       m_maxObjectWidth;   // Largest X extent of any bounding box.
+
+    // Ammo grid
+    float                       m_cellSize;
+    uint32                      m_bucketMask;
+    std::vector<Cell>           m_ammoCells;        // Cell of each ammo.
+    std::vector<uint32>         m_bucketStart;      // First entry of each bucket in m_bucketEntries.
+    std::vector<uint32>         m_bucketEntries;    // Ammo indices ordered by bucket.
+    std::vector<uint32>         m_candidates;
+    std::vector<AmmoPair>       m_ammoPairs;        // In increasing (one, two) order.
+};
+
+__forceinline const std::vector<AmmoPair>& BroadPhase::AmmoPairs()
+{
+    return m_ammoPairs;
+}
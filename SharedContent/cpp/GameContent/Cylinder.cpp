@@ -138,3 +138,20 @@ bool Cylinder::IsTouching(
 }
 
 //--------------------------------------------------------------------------------
+
+bool Cylinder::BoundingBox(
+    _Out_ XMFLOAT3 *minPoint,
+    _Out_ XMFLOAT3 *maxPoint
+    )
+{
+    // The box around both end caps of the cylinder.
+    XMVECTOR p0 = XMLoadFloat3(&m_position);
+    XMVECTOR p1 = p0 + XMLoadFloat3(&m_axis) * m_length;
+    XMVECTOR extent = XMVectorReplicate(m_radius);
+
+    XMStoreFloat3(minPoint, XMVectorMin(p0, p1) - extent);
+    XMStoreFloat3(maxPoint, XMVectorMax(p0, p1) + extent);
+    return true;
+}
+
+//--------------------------------------------------------------------------------
@@ -36,6 +36,11 @@ internal:
         _Out_ DirectX::XMFLOAT3 *normal
         ) override;
 
+    virtual bool BoundingBox(
+        _Out_ DirectX::XMFLOAT3 *minPoint,
+        _Out_ DirectX::XMFLOAT3 *maxPoint
+        ) override;
+
 protected:
     virtual void UpdatePosition() override;
 
@@ -193,6 +193,40 @@ bool Face::IsTouching(
 
 //--------------------------------------------------------------------------------
 
+bool Face::BoundingBox(
+    _Out_ XMFLOAT3 *minPoint,
+    _Out_ XMFLOAT3 *maxPoint
+    )
+{
+    XMVECTOR minVector = XMLoadFloat3(&m_point[0]);
+    XMVECTOR maxVector = minVector;
+
+    for (int i = 1; i < 4; i++)
+    {
+        minVector = XMVectorMin(minVector, XMLoadFloat3(&m_point[i]));
+        maxVector = XMVectorMax(maxVector, XMLoadFloat3(&m_point[i]));
+    }
+
+    // IsTouching compares the distance between opposite edges with the length of the
+    // edges, so for a parallelogram that is not a rectangle it accepts points outside the
+    // face.  Grow the box by the difference so it contains all of them.
+    float area = XMVectorGetX(
+        XMVector3Length(XMVector3Cross(XMLoadFloat3(&m_widthVector), XMLoadFloat3(&m_heightVector)))
+        );
+    float slack = 0.0f;
+    if (m_width > 0.0f && m_height > 0.0f)
+    {
+        slack = max(m_height - area / m_width, m_width - area / m_height);
+    }
+    XMVECTOR extent = XMVectorReplicate(slack);
+
+    XMStoreFloat3(minPoint, minVector - extent);
+    XMStoreFloat3(maxPoint, maxVector + extent);
+    return true;
+}
+
+//--------------------------------------------------------------------------------
+
 void Face::UpdateMatrix()
 {
     // Determine the Model transform for the cannonical face to align with the position
@@ -37,7 +37,8 @@ namespace GameConstants
         static const float BounceLost           = 0.1f;     // The proportion of velocity lost during a collision between 2 ammos.
         static const float RestThreshold        = 0.02f;    // The energy below which the ball is flagged as laying on ground.
                                                             // It is defined as Gravity * Height_above_ground + 0.5 * Velocity * Velocity.
-        static const float FrameLength          = 0.003f;   // The duration of a frame for physics handling when the graphics frame length is too long.
+        static const float FrameLength          = 0.003f;   // The duration of a physics time step.
+        static const int MaxStepsPerFrame       = 100;      // The most physics time steps computed in one frame; the rest of a long stall is dropped.
     }
 
     namespace Sound
@@ -18,6 +18,8 @@
 //
 // During the game physics calculations the IsTouching method will be called to determine
 // the object's proximity to a point.  It is expected the sub-classes will replace this method.
+// The BoundingBox method is used to skip the IsTouching calls for objects that are far
+// from the point.  Sub-classes that don't replace it are always tested with IsTouching.
 // The Render method will be called during rendering to include the object in the generation of
 // the scene.
 
@@ -44,6 +46,16 @@ internal:
         return false;
     };
 
+    // Returns the axis aligned box containing every point for which IsTouching can
+    // return true with a radius of 0.  Returns false if the object is not bounded.
+    virtual bool BoundingBox(
+        _Out_ DirectX::XMFLOAT3 * /* minPoint */,
+        _Out_ DirectX::XMFLOAT3 * /* maxPoint */
+        )
+    {
+        return false;
+    };
+
     void Render(
         _In_ ID3D11DeviceContext *context,
         _In_ ID3D11Buffer *primitiveConstantBuffer
@@ -71,6 +83,7 @@ internal:
     void PlaySound(float impactSpeed, DirectX::XMFLOAT3 eyePoint);
 
     void Mesh(_In_ MeshObject^ mesh);
+    MeshObject^ Mesh();
 
     void NormalMaterial(_In_ Material^ material);
     Material^ NormalMaterial();
@@ -257,6 +270,11 @@ __forceinline void GameObject::Mesh(_In_ MeshObject^ mesh)
     m_mesh = mesh;
 }
 
+__forceinline MeshObject^ GameObject::Mesh()
+{
+    return m_mesh;
+}
+
 __forceinline void GameObject::HitSound(_In_ SoundEffect^ hitSound)
 {
     m_hitSound = hitSound;
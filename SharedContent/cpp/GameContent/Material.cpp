@@ -43,12 +43,29 @@ void Material::RenderSetup(
     _In_ ID3D11DeviceContext* context,
     _Inout_ ConstantBufferChangesEveryPrim* constantBuffer
     )
+{
+    SetupConstants(constantBuffer);
+    SetupPipeline(context);
+}
+
+//--------------------------------------------------------------------------------
+
+void Material::SetupConstants(
+    _Inout_ ConstantBufferChangesEveryPrim* constantBuffer
+    )
 {
     constantBuffer->meshColor = m_meshColor;
     constantBuffer->specularColor = m_specularColor;
     constantBuffer->specularPower = m_specularExponent;
     constantBuffer->diffuseColor = m_diffuseColor;
+}
+
+//--------------------------------------------------------------------------------
 
+void Material::SetupPipeline(
+    _In_ ID3D11DeviceContext* context
+    )
+{
     context->PSSetShaderResources(0, 1, m_textureRV.GetAddressOf());
     context->VSSetShader(m_vertexShader.Get(), nullptr, 0);
     context->PSSetShader(m_pixelShader.Get(), nullptr, 0);
@@ -18,7 +18,9 @@
 // should be used for rendering.
 // The RenderSetup method sets the appropriate values into the constantBuffer
 // and calls the appropriate D3D11 context methods to set up the rendering pipeline
-// in the graphics hardware.
+// in the graphics hardware.  The two halves are also available separately as
+// SetupConstants and SetupPipeline, so the pipeline state can be shared by
+// consecutive objects using the same material.
 
 #include "ConstantBuffers.h"
 
@@ -40,6 +42,14 @@ internal:
         _Inout_ ConstantBufferChangesEveryPrim* constantBuffer
         );
 
+    void SetupConstants(
+        _Inout_ ConstantBufferChangesEveryPrim* constantBuffer
+        );
+
+    void SetupPipeline(
+        _In_ ID3D11DeviceContext* context
+        );
+
     void SetTexture(_In_ ID3D11ShaderResourceView* textureResourceView)
     {
         m_textureRV = textureResourceView;
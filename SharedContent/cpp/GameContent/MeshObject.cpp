@@ -26,6 +26,14 @@ MeshObject::MeshObject():
 //--------------------------------------------------------------------------------
 
 void MeshObject::Render(_In_ ID3D11DeviceContext *context)
+{
+    RenderSetup(context);
+    Draw(context);
+}
+
+//--------------------------------------------------------------------------------
+
+void MeshObject::RenderSetup(_In_ ID3D11DeviceContext *context)
 {
     uint32 stride = sizeof(PNTVertex);
     uint32 offset = 0;
@@ -33,6 +41,12 @@ void MeshObject::Render(_In_ ID3D11DeviceContext *context)
     context->IASetVertexBuffers(0, 1, m_vertexBuffer.GetAddressOf(), &stride, &offset);
     context->IASetIndexBuffer(m_indexBuffer.Get(), DXGI_FORMAT_R16_UINT, 0);
     context->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+}
+
+//--------------------------------------------------------------------------------
+
+void MeshObject::Draw(_In_ ID3D11DeviceContext *context)
+{
     context->DrawIndexed(m_indexCount, 0, 0);
 }
 
@@ -19,7 +19,8 @@
 // The primary method of the MeshObject is Render.  The default implementation
 // just sets the IndexBuffer, VertexBuffer and topology to a TriangleList and
 // makes a  DrawIndexed call on the context.  It assumes all other state has
-// already been set on the context.
+// already been set on the context.  RenderSetup and Draw are the two halves of
+// Render, so consecutive draws of the same mesh only set the buffers once.
 
 ref class MeshObject abstract
 {
@@ -27,6 +28,8 @@ internal:
     MeshObject();
 
     virtual void Render(_In_ ID3D11DeviceContext *context);
+    virtual void RenderSetup(_In_ ID3D11DeviceContext *context);
+    virtual void Draw(_In_ ID3D11DeviceContext *context);
 
 protected private:
     Microsoft::WRL::ComPtr<ID3D11Buffer>  m_vertexBuffer;
@@ -0,0 +1,208 @@
+//********************************************************* 
+// 
+// Copyright (c) Microsoft. All rights reserved. 
+// This code is licensed under the MIT License (MIT). 
+// THIS CODE IS PROVIDED *AS IS* WITHOUT WARRANTY OF 
+// ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING ANY 
+// IMPLIED WARRANTIES OF FITNESS FOR A PARTICULAR 
+// PURPOSE, MERCHANTABILITY, OR NON-INFRINGEMENT. 
+// 
+//*********************************************************
+
+#include "pch.h"
+#include "RenderList.h"
+#include <algorithm>
+
+using namespace DirectX;
+
+//----------------------------------------------------------------------
+
+RenderList::RenderList():
+    m_objectCount(0)
+{
+}
+
+//----------------------------------------------------------------------
+
+void RenderList::Build(
+    _In_ const std::vector<GameObject^>& objects,
+    _In_reads_(passCount) const XMFLOAT4X4* viewProjections,
+    uint32 passCount
+    )
+{
+    m_frustums.resize(passCount);
+    for (uint32 i = 0; i < passCount; i++)
+    {
+        ExtractFrustum(viewProjections[i], &m_frustums[i]);
+    }
+
+    // The draws are reused from frame to frame, only the entries past the new end are released.
+    uint32 drawCount = 0;
+    m_objectCount = static_cast<uint32>(objects.size());
+    if (m_draws.size() < objects.size())
+    {
+        m_draws.resize(objects.size());
+    }
+
+    for (auto object = objects.begin(); object != objects.end(); object++)
+    {
+        GameObject^ gameObject = *object;
+        if (!gameObject->Active() || (gameObject->Mesh() == nullptr) || (gameObject->NormalMaterial() == nullptr))
+        {
+            continue;
+        }
+
+        XMFLOAT3 minPoint;
+        XMFLOAT3 maxPoint;
+        if (gameObject->BoundingBox(&minPoint, &maxPoint) && !IsVisible(minPoint, maxPoint))
+        {
+            continue;
+        }
+
+        Draw& draw = m_draws[drawCount++];
+        draw.mesh = gameObject->Mesh();
+        if (gameObject->Hit() && gameObject->HitMaterial() != nullptr)
+        {
+            draw.material = gameObject->HitMaterial();
+        }
+        else
+        {
+            draw.material = gameObject->NormalMaterial();
+        }
+
+        XMStoreFloat4x4(
+            &draw.constants.worldMatrix,
+            XMMatrixTranspose(gameObject->ModelMatrix())
+            );
+        draw.material->SetupConstants(&draw.constants);
+    }
+
+    for (uint32 i = drawCount; i < m_draws.size(); i++)
+    {
+        m_draws[i].material = nullptr;
+        m_draws[i].mesh = nullptr;
+    }
+
+    // Sort by the identity of the material and then the mesh.  The order between different
+    // materials doesn't matter, only that equal ones are next to each other.
+    m_order.resize(drawCount);
+    for (uint32 i = 0; i < drawCount; i++)
+    {
+        m_order[i] = i;
+    }
+
+    const std::vector<Draw>& draws = m_draws;
+    std::sort(
+        m_order.begin(),
+        m_order.end(),
+        [&draws](uint32 a, uint32 b)
+        {
+            auto materialA = reinterpret_cast<uintptr_t>(reinterpret_cast<IInspectable*>(draws[a].material));
+            auto materialB = reinterpret_cast<uintptr_t>(reinterpret_cast<IInspectable*>(draws[b].material));
+            if (materialA != materialB)
+            {
+                return materialA < materialB;
+            }
+
+            auto meshA = reinterpret_cast<uintptr_t>(reinterpret_cast<IInspectable*>(draws[a].mesh));
+            auto meshB = reinterpret_cast<uintptr_t>(reinterpret_cast<IInspectable*>(draws[b].mesh));
+            if (meshA != meshB)
+            {
+                return meshA < meshB;
+            }
+
+            // Keep the draw order stable between frames.
+            return a < b;
+        }
+        );
+}
+
+//----------------------------------------------------------------------
+
+void RenderList::Render(
+    _In_ ID3D11DeviceContext* context,
+    _In_ ID3D11Buffer* primitiveConstantBuffer
+    )
+{
+    Material^ currentMaterial = nullptr;
+    MeshObject^ currentMesh = nullptr;
+
+    for (auto index = m_order.begin(); index != m_order.end(); index++)
+    {
+        Draw& draw = m_draws[*index];
+
+        if (draw.material != currentMaterial)
+        {
+            draw.material->SetupPipeline(context);
+            currentMaterial = draw.material;
+        }
+        if (draw.mesh != currentMesh)
+        {
+            draw.mesh->RenderSetup(context);
+            currentMesh = draw.mesh;
+        }
+
+        context->UpdateSubresource(primitiveConstantBuffer, 0, nullptr, &draw.constants, 0, 0);
+        draw.mesh->Draw(context);
+    }
+}
+
+//----------------------------------------------------------------------
+
+void RenderList::ExtractFrustum(
+    _In_ const XMFLOAT4X4& viewProjection,
+    _Out_ Frustum* frustum
+    )
+{
+    // The planes are combinations of the columns of the view * projection matrix
+    // (Gribb/Hartmann), with the D3D clip space depth range of 0 to w.  A point p is
+    // inside when dot(plane, p) >= 0 for all of them.  The planes are not normalized
+    // since only the sign of the distance is used.
+    XMMATRIX columns = XMMatrixTranspose(XMLoadFloat4x4(&viewProjection));
+
+    XMStoreFloat4(&frustum->planes[0], XMVectorAdd(columns.r[3], columns.r[0]));        // Left
+    XMStoreFloat4(&frustum->planes[1], XMVectorSubtract(columns.r[3], columns.r[0]));   // Right
+    XMStoreFloat4(&frustum->planes[2], XMVectorAdd(columns.r[3], columns.r[1]));        // Bottom
+    XMStoreFloat4(&frustum->planes[3], XMVectorSubtract(columns.r[3], columns.r[1]));   // Top
+    XMStoreFloat4(&frustum->planes[4], columns.r[2]);                                   // Near
+    XMStoreFloat4(&frustum->planes[5], XMVectorSubtract(columns.r[3], columns.r[2]));   // Far
+}
+
+//----------------------------------------------------------------------
+
+bool RenderList::IsVisible(
+    XMFLOAT3 minPoint,
+    XMFLOAT3 maxPoint
+    )
+{
+    XMVECTOR boxMin = XMLoadFloat3(&minPoint);
+    XMVECTOR boxMax = XMLoadFloat3(&maxPoint);
+    XMVECTOR center = XMVectorSetW(XMVectorScale(XMVectorAdd(boxMin, boxMax), 0.5f), 1.0f);
+    XMVECTOR extent = XMVectorScale(XMVectorSubtract(boxMax, boxMin), 0.5f);
+
+    for (auto frustum = m_frustums.begin(); frustum != m_frustums.end(); frustum++)
+    {
+        bool inside = true;
+        for (int i = 0; i < 6; i++)
+        {
+            // Distance of the box corner furthest along the plane normal.  When even that
+            // corner is behind the plane the whole box is outside.
+            XMVECTOR plane = XMLoadFloat4(&frustum->planes[i]);
+            XMVECTOR distance = XMVectorAdd(
+                XMVector4Dot(plane, center),
+                XMVector3Dot(XMVectorAbs(plane), extent)
+                );
+            if (XMVectorGetX(distance) < 0.0f)
+            {
+                inside = false;
+                break;
+            }
+        }
+
+        if (inside)
+        {
+            return true;
+        }
+    }
+    return false;
+}
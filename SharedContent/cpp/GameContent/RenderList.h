@@ -0,0 +1,86 @@
+//********************************************************* 
+// 
+// Copyright (c) Microsoft. All rights reserved. 
+// This code is licensed under the MIT License (MIT). 
+// THIS CODE IS PROVIDED *AS IS* WITHOUT WARRANTY OF 
+// ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING ANY 
+// IMPLIED WARRANTIES OF FITNESS FOR A PARTICULAR 
+// PURPOSE, MERCHANTABILITY, OR NON-INFRINGEMENT. 
+// 
+//*********************************************************
+
+#pragma once
+
+// RenderList:
+// This class builds the list of draws for a frame once, and replays it for each rendering
+// pass (one for mono, two for stereo).
+//     Culling - the bounding box of each active object is tested against the view frustum of
+//         every pass.  An object is drawn when it is at least partially inside any of them.
+//         Objects without a bounding box are always drawn.
+//     Sorting - the draws are sorted by material and then by mesh, so the shaders, texture
+//         and buffers are only set on the context when they change from the previous draw.
+// The per-primitive constants (world matrix and material colors) are computed once during
+// Build, so each pass only has to copy them into the constant buffer.
+
+#include "GameObject.h"
+
+ref class RenderList
+{
+internal:
+    RenderList();
+
+    // Rebuilds the draws from the current state of the objects.  viewProjections holds the
+    // view * projection matrix of each rendering pass.
+    void Build(
+        _In_ const std::vector<GameObject^>& objects,
+        _In_reads_(passCount) const DirectX::XMFLOAT4X4* viewProjections,
+        uint32 passCount
+        );
+
+    // Issues the draws.  Expects the input layout, constant buffers and sampler to be set.
+    void Render(
+        _In_ ID3D11DeviceContext* context,
+        _In_ ID3D11Buffer* primitiveConstantBuffer
+        );
+
+    // Number of objects considered by the last Build, and the number of them that are drawn.
+    uint32 ObjectCount();
+    uint32 DrawCount();
+
+private:
+    struct Frustum
+    {
+        DirectX::XMFLOAT4   planes[6];
+    };
+
+    struct Draw
+    {
+        Material^                       material;
+        MeshObject^                     mesh;
+        ConstantBufferChangesEveryPrim  constants;
+    };
+
+    void ExtractFrustum(
+        _In_ const DirectX::XMFLOAT4X4& viewProjection,
+        _Out_ Frustum* frustum
+        );
+    bool IsVisible(
+        DirectX::XMFLOAT3 minPoint,
+        DirectX::XMFLOAT3 maxPoint
+        );
+
+    std::vector<Frustum>    m_frustums;
+    std::vector<Draw>       m_draws;
+    std::vector<uint32>     m_order;
+    uint32                  m_objectCount;
+};
+
+__forceinline uint32 RenderList::ObjectCount()
+{
+    return m_objectCount;
+}
+
+__forceinline uint32 RenderList::DrawCount()
+{
+    return static_cast<uint32>(m_order.size());
+}
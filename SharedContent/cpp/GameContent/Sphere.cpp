@@ -81,3 +81,17 @@ bool Sphere::IsTouching(
 }
 
 //----------------------------------------------------------------------
+
+bool Sphere::BoundingBox(
+    _Out_ XMFLOAT3 *minPoint,
+    _Out_ XMFLOAT3 *maxPoint
+    )
+{
+    XMVECTOR extent = XMVectorReplicate(m_radius);
+
+    XMStoreFloat3(minPoint, XMLoadFloat3(&m_position) - extent);
+    XMStoreFloat3(maxPoint, XMLoadFloat3(&m_position) + extent);
+    return true;
+}
+
+//----------------------------------------------------------------------